@@ -0,0 +1,221 @@
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <malloc.h>
+#include <sys/mman.h>
+
+#pragma once
+
+/*
+ * Couche d'allocation du programme : remplace l'opérateur new global pour
+ * que le tableau d'entrée et tous les tableaux auxiliaires (tampons des
+ * tris, y compris celui, caché, de std::inplace_merge) en profitent.
+ * Par défaut, rien ne change : malloc et free. Avec HUGE_PAGES (--hugepages) :
+ * - tout tableau d'au moins une page est aligné sur une ligne de cache
+ *   (64 octets) ; les petits blocs restent à malloc, plus rapide que
+ *   aligned_alloc pour les innombrables tampons de std::inplace_merge ;
+ * - un bloc d'au moins HUGE_PAGE_BYTES est projeté directement, sur des
+ *   pages de 2 Mio réservées (MAP_HUGETLB) ou, à défaut, sur une zone
+ *   alignée sur 2 Mio marquée MADV_HUGEPAGE (pages énormes transparentes).
+ *   Une page couvre alors 512 fois plus de mémoire : beaucoup moins de
+ *   défauts de TLB pour les accès aléatoires (qsort, dispersions du tri par base).
+ */
+
+const std::size_t HUGE_PAGE_BYTES = std::size_t(2) << 20;
+const std::size_t ALLOC_ALIGN = 64;
+const std::size_t ALLOC_ALIGN_MIN_BYTES = 4096;
+// Blocs projetés libérés gardés pour être réutilisés sans nouveaux défauts de page.
+const std::size_t HUGE_CACHE_BLOCKS = 8;
+
+bool HUGE_PAGES = false;
+
+/*
+ * Comptabilité des allocations (--memory, voir memory.hpp) : tant que
+ * ALLOC_ACCOUNTING est vrai, new compte les appels et les octets demandés,
+ * et new et delete suivent les octets vivants (taille réelle du bloc) et
+ * leur maximum. Atomiques : les fils du bassin allouent aussi.
+ */
+struct AllocCounters {
+    std::atomic<std::size_t> allocations{0};
+    std::atomic<std::size_t> bytes{0};
+    std::atomic<std::ptrdiff_t> live{0};
+    std::atomic<std::ptrdiff_t> peak{0};
+};
+
+std::atomic<bool> ALLOC_ACCOUNTING{false};
+AllocCounters ALLOC_COUNTERS;
+
+/*
+ * Un bloc projeté commence sur une frontière de 2 Mio par cet en-tête, et
+ * l'utilisateur reçoit l'adresse située ALLOC_ALIGN octets plus loin.
+ * delete ne lit jamais l'en-tête supposé d'un bloc quelconque : ces octets
+ * appartiendraient au bloc de malloc voisin. Il cherche d'abord l'adresse
+ * dans le registre des blocs projetés, et n'y va que si l'un d'eux a déjà
+ * été projeté.
+ */
+struct HugeHeader {
+    std::size_t length;
+};
+
+// Blocs projetés à la fois, vivants ou en cache ; au-delà, aligned_alloc.
+const std::size_t HUGE_MAX_BLOCKS = 64;
+
+struct HugeCache {
+    std::mutex mutex;
+    void* mapped[HUGE_MAX_BLOCKS] = {};
+    std::size_t mappedCount = 0;
+    void* blocks[HUGE_CACHE_BLOCKS] = {};
+    std::size_t count = 0;
+};
+
+HugeCache& huge_cache() {
+    static HugeCache cache;
+    return cache;
+}
+
+// Vrai dès la première projection : avant, delete ne consulte pas le registre.
+std::atomic<bool> HUGE_MAPPED{false};
+
+void* huge_map(std::size_t size) {
+    const std::size_t length = (size + ALLOC_ALIGN + HUGE_PAGE_BYTES - 1) / HUGE_PAGE_BYTES * HUGE_PAGE_BYTES;
+    auto& cache = huge_cache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+
+    // Réutiliser un bloc libéré assez grand, mais pas plus du double.
+    for (std::size_t i = 0; i < cache.count; ++i) {
+        auto header = static_cast<HugeHeader*>(cache.blocks[i]);
+        if (header->length >= length && header->length <= 2 * length) {
+            cache.blocks[i] = cache.blocks[--cache.count];
+            return reinterpret_cast<char*>(header) + ALLOC_ALIGN;
+        }
+    }
+    if (cache.mappedCount == HUGE_MAX_BLOCKS)
+        return nullptr;
+
+    void* p = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (p == MAP_FAILED) {
+        // Pas de pages réservées : une zone alignée sur 2 Mio pour que le
+        // noyau puisse la couvrir de pages énormes transparentes.
+        void* raw = mmap(nullptr, length + HUGE_PAGE_BYTES, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED)
+            return nullptr;
+        auto base = reinterpret_cast<std::uintptr_t>(raw);
+        auto aligned = (base + HUGE_PAGE_BYTES - 1) / HUGE_PAGE_BYTES * HUGE_PAGE_BYTES;
+        if (aligned > base)
+            munmap(raw, aligned - base);
+        munmap(reinterpret_cast<void*>(aligned + length), base + HUGE_PAGE_BYTES - aligned);
+        p = reinterpret_cast<void*>(aligned);
+        madvise(p, length, MADV_HUGEPAGE);
+    }
+    static_cast<HugeHeader*>(p)->length = length;
+    cache.mapped[cache.mappedCount++] = p;
+    HUGE_MAPPED.store(true, std::memory_order_relaxed);
+    return static_cast<char*>(p) + ALLOC_ALIGN;
+}
+
+// En-tête du bloc projeté qui commence en p, ou nullptr si p n'en est pas un.
+HugeHeader* huge_header(void* p) {
+    if (!HUGE_MAPPED.load(std::memory_order_relaxed) ||
+        reinterpret_cast<std::uintptr_t>(p) % HUGE_PAGE_BYTES != ALLOC_ALIGN)
+        return nullptr;
+    void* base = static_cast<char*>(p) - ALLOC_ALIGN;
+    auto& cache = huge_cache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    for (std::size_t i = 0; i < cache.mappedCount; ++i)
+        if (cache.mapped[i] == base)
+            return static_cast<HugeHeader*>(base);
+    return nullptr;
+}
+
+// Rend un bloc projeté au cache ; renvoie faux si p n'en est pas un.
+bool huge_release(void* p) {
+    auto header = huge_header(p);
+    if (!header)
+        return false;
+
+    auto& cache = huge_cache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    if (cache.count == HUGE_CACHE_BLOCKS) {
+        // Cache plein : le plus ancien est rendu au système et oublié.
+        auto oldest = static_cast<HugeHeader*>(cache.blocks[0]);
+        for (std::size_t i = 0; i < cache.mappedCount; ++i)
+            if (cache.mapped[i] == oldest) {
+                cache.mapped[i] = cache.mapped[--cache.mappedCount];
+                break;
+            }
+        munmap(oldest, oldest->length);
+        for (std::size_t i = 1; i < cache.count; ++i)
+            cache.blocks[i - 1] = cache.blocks[i];
+        --cache.count;
+    }
+    cache.blocks[cache.count++] = header;
+    return true;
+}
+
+// Octets réellement occupés par le bloc p, projeté ou issu de malloc.
+std::size_t alloc_block_size(void* p) {
+    auto header = huge_header(p);
+    return header ? header->length : malloc_usable_size(p);
+}
+
+void alloc_account(void* p, std::size_t size) {
+    auto& c = ALLOC_COUNTERS;
+    c.allocations.fetch_add(1, std::memory_order_relaxed);
+    c.bytes.fetch_add(size, std::memory_order_relaxed);
+    std::ptrdiff_t block = alloc_block_size(p);
+    std::ptrdiff_t live = c.live.fetch_add(block, std::memory_order_relaxed) + block;
+    std::ptrdiff_t peak = c.peak.load(std::memory_order_relaxed);
+    while (live > peak && !c.peak.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+        ;
+}
+
+void* operator new(std::size_t size) {
+    void* p;
+    if (!HUGE_PAGES) {
+        p = std::malloc(size ? size : 1);
+    } else {
+        p = size >= HUGE_PAGE_BYTES ? huge_map(size) : nullptr;
+        if (!p && size >= ALLOC_ALIGN_MIN_BYTES)
+            p = std::aligned_alloc(ALLOC_ALIGN, (size + ALLOC_ALIGN - 1) / ALLOC_ALIGN * ALLOC_ALIGN);
+        else if (!p)
+            p = std::malloc(size ? size : 1);
+    }
+    if (!p)
+        throw std::bad_alloc();
+    if (ALLOC_ACCOUNTING.load(std::memory_order_relaxed))
+        alloc_account(p, size);
+    return p;
+}
+
+// std::get_temporary_buffer (std::inplace_merge) alloue par cette variante :
+// elle doit passer par la même couche que delete.
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return operator new(size);
+    } catch (const std::bad_alloc&) {
+        return nullptr;
+    }
+}
+
+// Hors ligne : sinon GCC voit free() sur un pointeur issu de new et s'en inquiète.
+__attribute__((noinline)) void operator delete(void* p) noexcept {
+    if (!p)
+        return;
+    if (ALLOC_ACCOUNTING.load(std::memory_order_relaxed))
+        ALLOC_COUNTERS.live.fetch_sub(alloc_block_size(p), std::memory_order_relaxed);
+    if (!huge_release(p))
+        std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    operator delete(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+    operator delete(p);
+}
@@ -0,0 +1,229 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include "io.hpp"
+
+#pragma once
+
+/*
+ * File bornée en octets entre deux étages du traitement par lots : push
+ * bloque tant que les données en attente dépasseraient la capacité (un
+ * élément seul passe toujours, même plus gros). close() signale la fin ;
+ * pop renvoie faux une fois la file fermée et vide, et push sur une file
+ * fermée (un étage en aval a échoué) jette l'élément sans attendre.
+ */
+template <typename T>
+class BoundedQueue
+{
+public:
+    explicit BoundedQueue(std::size_t capacityBytes);
+
+    void push(T item, std::size_t bytes);
+    bool pop(T& item);
+    void close();
+
+private:
+    std::mutex mutex;
+    std::condition_variable notFull;
+    std::condition_variable notEmpty;
+    std::deque<std::pair<T, std::size_t>> items;
+    std::size_t capacity;
+    std::size_t used = 0;
+    bool closed = false;
+};
+
+template <typename T>
+BoundedQueue<T>::BoundedQueue(std::size_t capacityBytes)
+    : capacity(capacityBytes)
+{}
+
+template <typename T>
+void BoundedQueue<T>::push(T item, std::size_t bytes) {
+    std::unique_lock<std::mutex> lock(mutex);
+    notFull.wait(lock, [&] { return closed || items.empty() || used + bytes <= capacity; });
+    if (closed)
+        return;
+    used += bytes;
+    items.emplace_back(std::move(item), bytes);
+    notEmpty.notify_one();
+}
+
+template <typename T>
+bool BoundedQueue<T>::pop(T& item) {
+    std::unique_lock<std::mutex> lock(mutex);
+    notEmpty.wait(lock, [&] { return closed || !items.empty(); });
+    if (items.empty())
+        return false;
+    item = std::move(items.front().first);
+    used -= items.front().second;
+    items.pop_front();
+    notFull.notify_all();
+    return true;
+}
+
+template <typename T>
+void BoundedQueue<T>::close() {
+    std::lock_guard<std::mutex> lock(mutex);
+    closed = true;
+    notEmpty.notify_all();
+    notFull.notify_all();
+}
+
+template <typename T>
+struct BatchItem {
+    std::string name;
+    std::vector<T> numbers;
+    double sortTime = 0;
+};
+
+/*
+ * Trie tous les fichiers d'un répertoire en pipeline :
+ * - un fil lit et analyse les fichiers suivants (dans l'ordre des noms) ;
+ * - workers fils trient les fichiers déjà chargés ;
+ * - un fil écrit les résultats dans outDir (texte, ou format binaire).
+ * Les deux files entre étages sont bornées par budgetBytes chacune : la
+ * mémoire reste plafonnée, et le temps total tend vers celui de l'étage le
+ * plus lent. Sans outDir, les résultats sont seulement chronométrés.
+ * Avec printTime, une ligne CSV par fichier (fichier,taille,temps du tri)
+ * et, sur stderr, le temps occupé de chaque étage et le temps total.
+ * La première erreur d'un étage (fichier illisible, écriture impossible)
+ * est gardée, les files sont fermées pour que tous les fils s'arrêtent,
+ * puis elle est relancée ici, dans le fil appelant.
+ */
+template <typename T>
+void batch_sort(const std::string& dir, void (*algo)(T*, std::size_t),
+                const std::string& outDir, bool binary, bool printTime,
+                std::size_t budgetBytes, unsigned int workers) {
+    using namespace std::chrono;
+    using Item = BatchItem<T>;
+    namespace fs = std::filesystem;
+
+    if (!outDir.empty() && !fs::is_directory(outDir))
+        throw std::runtime_error(outDir + " : pas un répertoire");
+
+    std::vector<fs::path> paths;
+    for (auto& entry : fs::directory_iterator(dir))
+        if (entry.is_regular_file())
+            paths.push_back(entry.path());
+    std::sort(paths.begin(), paths.end());
+
+    BoundedQueue<Item> toSort(budgetBytes);
+    BoundedQueue<Item> toWrite(budgetBytes);
+    double readBusy = 0, writeBusy = 0;
+    std::vector<double> sortBusy(std::max(workers, 1u), 0);
+    auto start = steady_clock::now();
+
+    std::mutex errorMutex;
+    std::exception_ptr error;
+    std::atomic<bool> failed{false};
+    auto fail = [&] {
+        {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!error)
+                error = std::current_exception();
+        }
+        failed = true;
+        toSort.close();
+        toWrite.close();
+    };
+
+    std::thread reader([&] {
+        try {
+            for (auto& path : paths) {
+                if (failed)
+                    break;
+                auto t0 = steady_clock::now();
+                Item item;
+                item.name = path.filename().string();
+                item.numbers = load_numbers<T>(path.string());
+                readBusy += duration<double>(steady_clock::now() - t0).count();
+                std::size_t bytes = item.numbers.size() * sizeof(T);
+                toSort.push(std::move(item), bytes);
+            }
+        } catch (...) {
+            fail();
+        }
+        toSort.close();
+    });
+
+    std::vector<std::thread> sorters;
+    for (std::size_t w = 0; w < sortBusy.size(); ++w)
+        sorters.emplace_back([&, w] {
+            try {
+                Item item;
+                while (!failed && toSort.pop(item)) {
+                    auto t0 = steady_clock::now();
+                    algo(item.numbers.data(), item.numbers.size());
+                    item.sortTime = duration<double>(steady_clock::now() - t0).count();
+                    sortBusy[w] += item.sortTime;
+                    std::size_t bytes = item.numbers.size() * sizeof(T);
+                    toWrite.push(std::move(item), bytes);
+                }
+            } catch (...) {
+                fail();
+            }
+        });
+
+    std::thread writer([&] {
+        try {
+            Item item;
+            while (!failed && toWrite.pop(item)) {
+                auto t0 = steady_clock::now();
+                if (!outDir.empty()) {
+                    std::string path = outDir + "/" + item.name;
+                    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+                    if (fd < 0)
+                        throw std::system_error(errno, std::generic_category(), path);
+                    {
+                        OutputWriter out(fd, false);
+                        if (binary) {
+                            auto header = binary_header<T>(item.numbers.size());
+                            out.bytes(&header, sizeof(header));
+                            out.bytes(item.numbers.data(), item.numbers.size() * sizeof(T));
+                        } else {
+                            for (auto n : item.numbers)
+                                out.text(n);
+                        }
+                    }
+                    close(fd);
+                }
+                writeBusy += duration<double>(steady_clock::now() - t0).count();
+                if (printTime)
+                    std::cout << item.name << "," << item.numbers.size() << ","
+                              << std::fixed << item.sortTime << std::endl;
+            }
+        } catch (...) {
+            fail();
+        }
+    });
+
+    reader.join();
+    for (auto& s : sorters)
+        s.join();
+    toWrite.close();
+    writer.join();
+    if (error)
+        std::rethrow_exception(error);
+
+    if (printTime) {
+        double total = duration<double>(steady_clock::now() - start).count();
+        std::cerr << std::fixed << "lecture " << readBusy
+                  << " tri " << *std::max_element(sortBusy.begin(), sortBusy.end())
+                  << " ecriture " << writeBusy << " total " << total << std::endl;
+    }
+}
@@ -0,0 +1,154 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "alloc.hpp"
+#include "counters.hpp"
+#include "memory.hpp"
+#include "pool.hpp"
+
+#pragma once
+
+const unsigned int BENCH_DEFAULT_REPEATS = 5;
+const unsigned int BENCH_DEFAULT_WARMUP = 1;
+
+struct BenchStats {
+    double min;
+    double median;
+    double p95;
+    double stddev;
+};
+
+BenchStats bench_stats(std::vector<double> times) {
+    BenchStats stats{0, 0, 0, 0};
+    if (times.empty())
+        return stats;
+    std::sort(times.begin(), times.end());
+    const std::size_t n = times.size();
+    stats.min = times[0];
+    stats.median = n % 2 ? times[n / 2] : (times[n / 2 - 1] + times[n / 2]) / 2;
+    // Rang le plus proche : la plus petite mesure qui couvre 95 % des essais.
+    stats.p95 = times[std::min(n - 1, static_cast<std::size_t>(std::ceil(0.95 * n)) - 1)];
+    if (n > 1) {
+        double mean = 0;
+        for (auto t : times)
+            mean += t;
+        mean /= n;
+        double var = 0;
+        for (auto t : times)
+            var += (t - mean) * (t - mean);
+        stats.stddev = std::sqrt(var / (n - 1));
+    }
+    return stats;
+}
+
+/*
+ * Banc d'essai dans un seul processus : chaque fichier est chargé une fois,
+ * puis chaque algorithme est lancé warmup fois sans mesure et repeats fois
+ * avec mesure, toujours sur une copie fraîche des données.
+ * Une ligne CSV par (algo, fichier) ; temps vaut la médiane, ce qui garde
+ * le format de results.csv lisible par test_puissance.py et test_constantes.py.
+ * Avec threads, chaque mesure est refaite pour chaque nombre de fils et les
+ * colonnes fils et acceleration (par rapport au premier nombre, avec le même
+ * allocateur) s'ajoutent.
+ * Avec hugePages, chaque mesure est faite sans puis avec les pages énormes
+ * (voir alloc.hpp) et la colonne grandes_pages (0 ou 1) s'ajoute.
+ * Avec counters, les compteurs matériels moyens des essais mesurés suivent.
+ * Avec memory, l'empreinte mémoire (voir memory.hpp) la plus forte des
+ * essais mesurés ferme la ligne.
+ */
+template <typename T, typename Loader>
+void bench(const std::vector<std::string>& files,
+           const std::vector<std::pair<std::string, void (*)(T*, std::size_t)>>& algos,
+           unsigned int repeats, unsigned int warmup, bool counters, bool memory,
+           const std::vector<unsigned int>& threads, bool hugePages, Loader load,
+           std::ostream& out) {
+    using namespace std::chrono;
+    PerfCounters perf(counters);
+    // Les fils du bassin, recréés après l'ouverture, sont comptés eux aussi.
+    if (perf.available())
+        ThreadPool::restart();
+    MemoryAccount account(memory);
+    out << "algo,taille,temps,min,p95,ecart_type";
+    if (!threads.empty())
+        out << ",fils,acceleration";
+    if (hugePages)
+        out << ",grandes_pages";
+    if (counters)
+        out << "," << PerfCounters::header();
+    if (memory)
+        out << "," << MemoryAccount::header();
+    out << std::endl;
+    out << std::fixed;
+
+    // Un seul passage sans changer le bassin si aucun nombre de fils n'est donné.
+    struct Pass {
+        unsigned int threads;
+        bool hugePages;
+    };
+    std::vector<Pass> passes;
+    for (auto t : threads.empty() ? std::vector<unsigned int>{0} : threads) {
+        passes.push_back({t, false});
+        if (hugePages)
+            passes.push_back({t, true});
+    }
+
+    for (auto& path : files) {
+        const std::vector<T> numbers = load(path);
+        for (auto& a : algos) {
+            // Référence de l'accélération : premier passage du même allocateur.
+            double reference[2] = {0, 0};
+            for (auto& pass : passes) {
+                const unsigned int t = pass.threads;
+                if (t) {
+                    ThreadPool::setThreadCount(t);
+                    ThreadPool::global();
+                }
+                HUGE_PAGES = pass.hugePages;
+                std::vector<double> times;
+                std::vector<double> events(PerfCounters::EVENT_COUNT, 0);
+                std::vector<double> usage(MemoryAccount::MEASURE_COUNT, 0);
+                for (unsigned int r = 0; r < warmup + repeats; ++r) {
+                    auto copy = numbers;
+                    if (memory)
+                        account.start();
+                    if (counters && r >= warmup)
+                        perf.start();
+                    auto start = steady_clock::now();
+                    a.second(copy.data(), copy.size());
+                    auto end = steady_clock::now();
+                    auto used = account.stop();
+                    if (r < warmup)
+                        continue;
+                    times.push_back(duration<double>(end - start).count());
+                    if (counters) {
+                        auto v = perf.stop();
+                        for (std::size_t e = 0; e < v.size(); ++e)
+                            events[e] += v[e] / repeats;
+                    }
+                    for (std::size_t m = 0; m < used.size(); ++m)
+                        usage[m] = std::isnan(used[m]) ? used[m] : std::max(usage[m], used[m]);
+                }
+                auto stats = bench_stats(times);
+                double& ref = reference[pass.hugePages];
+                if (ref == 0)
+                    ref = stats.median;
+                out << a.first << "," << numbers.size() << "," << stats.median << ","
+                    << stats.min << "," << stats.p95 << "," << stats.stddev;
+                if (t)
+                    out << "," << t << "," << (stats.median > 0 ? ref / stats.median : 1);
+                if (hugePages)
+                    out << "," << pass.hugePages;
+                if (counters)
+                    out << "," << PerfCounters::csv(events, numbers.size());
+                if (memory)
+                    out << "," << MemoryAccount::csv(usage);
+                out << std::endl;
+            }
+        }
+    }
+}
@@ -0,0 +1,46 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#pragma once
+
+/*
+ * Compaction des clés : si max - min tient sur 16 ou 32 bits, on trie les
+ * décalages x - min dans un type plus étroit. Chaque ligne de cache porte
+ * alors 2 ou 4 fois plus de clés, pour tous les algorithmes.
+ */
+
+// Nombre de bits nécessaires pour représenter max - min (0 si tout est égal).
+template <typename T>
+unsigned int range_bits(const T* v, std::size_t n, T& lo) {
+    using U = typename std::make_unsigned<T>::type;
+    if (n == 0) {
+        lo = T();
+        return 0;
+    }
+    auto bounds = std::minmax_element(v, v + n);
+    lo = *bounds.first;
+    U span = static_cast<U>(*bounds.second) - static_cast<U>(lo);
+    unsigned int bits = 0;
+    while (bits < sizeof(T) * 8 && (span >> bits) != 0)
+        ++bits;
+    return bits;
+}
+
+template <typename Narrow, typename T>
+std::vector<Narrow> narrow_keys(const T* v, std::size_t n, T lo) {
+    using U = typename std::make_unsigned<T>::type;
+    std::vector<Narrow> narrow(n);
+    for (std::size_t i = 0; i < n; ++i)
+        narrow[i] = static_cast<Narrow>(static_cast<U>(v[i]) - static_cast<U>(lo));
+    return narrow;
+}
+
+template <typename Narrow, typename T>
+void widen_keys(const std::vector<Narrow>& narrow, T lo, T* v) {
+    using U = typename std::make_unsigned<T>::type;
+    for (std::size_t i = 0; i < narrow.size(); ++i)
+        v[i] = static_cast<T>(static_cast<U>(lo) + narrow[i]);
+}
@@ -0,0 +1,153 @@
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#pragma once
+
+/*
+ * Compteurs matériels (perf_event_open) autour d'un appel de tri.
+ * Deux groupes, chacun ordonnancé d'un bloc sur le PMU : {cycles,
+ * instructions, mauvaises prédictions} et {défauts L1d, LLC, dTLB}.
+ * Si le noyau multiplexe les groupes, les valeurs sont extrapolées avec
+ * time_enabled / time_running. Les compteurs sont hérités (inherit) : les
+ * fils créés après leur ouverture sont comptés avec le fil appelant. Pour
+ * que les algorithmes parallèles soient mesurés en entier, le bassin doit
+ * donc être recréé une fois les compteurs ouverts (ThreadPool::restart).
+ */
+class PerfCounters
+{
+public:
+    enum Event { CYCLES, INSTRUCTIONS, BRANCH_MISSES, L1D_MISSES, LLC_MISSES, DTLB_MISSES, EVENT_COUNT };
+
+    explicit PerfCounters(bool enable);
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+    ~PerfCounters();
+
+    bool available() const noexcept;
+    void start();
+    std::vector<double> stop();
+
+    static std::string header();
+    static std::string csv(const std::vector<double>& values, std::size_t n);
+
+private:
+    struct Group {
+        int leader = -1;
+        std::vector<int> fds;
+        std::vector<Event> events;
+    };
+
+    void open(Group& group, Event event, std::uint32_t type, std::uint64_t config);
+
+    Group groups[2];
+};
+
+// Configuration d'un événement « défaut de lecture » dans le cache donné.
+std::uint64_t perf_cache_miss(std::uint64_t cache) {
+    return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+
+PerfCounters::PerfCounters(bool enable) {
+    if (!enable)
+        return;
+    open(groups[0], CYCLES, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    open(groups[0], INSTRUCTIONS, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    open(groups[0], BRANCH_MISSES, PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+    open(groups[1], L1D_MISSES, PERF_TYPE_HW_CACHE, perf_cache_miss(PERF_COUNT_HW_CACHE_L1D));
+    open(groups[1], LLC_MISSES, PERF_TYPE_HW_CACHE, perf_cache_miss(PERF_COUNT_HW_CACHE_LL));
+    open(groups[1], DTLB_MISSES, PERF_TYPE_HW_CACHE, perf_cache_miss(PERF_COUNT_HW_CACHE_DTLB));
+    if (!available())
+        std::cerr << "compteurs matériels indisponibles (perf_event_paranoid ?)" << std::endl;
+}
+
+PerfCounters::~PerfCounters() {
+    for (auto& g : groups)
+        for (int fd : g.fds)
+            close(fd);
+}
+
+void PerfCounters::open(Group& group, Event event, std::uint32_t type, std::uint64_t config) {
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = group.leader < 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.inherit = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                       PERF_FORMAT_TOTAL_TIME_RUNNING;
+    int fd = syscall(SYS_perf_event_open, &attr, 0, -1, group.leader, 0);
+    if (fd < 0)
+        return;
+    if (group.leader < 0)
+        group.leader = fd;
+    group.fds.push_back(fd);
+    group.events.push_back(event);
+}
+
+bool PerfCounters::available() const noexcept {
+    return groups[0].leader >= 0 || groups[1].leader >= 0;
+}
+
+void PerfCounters::start() {
+    for (auto& g : groups) {
+        if (g.leader < 0)
+            continue;
+        ioctl(g.leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(g.leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+}
+
+// Renvoie une valeur par Event ; NAN pour un événement indisponible.
+std::vector<double> PerfCounters::stop() {
+    std::vector<double> values(EVENT_COUNT, NAN);
+    for (auto& g : groups) {
+        if (g.leader < 0)
+            continue;
+        ioctl(g.leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        std::vector<std::uint64_t> buf(3 + g.fds.size());
+        if (::read(g.leader, buf.data(), buf.size() * sizeof(std::uint64_t)) <= 0)
+            continue;
+        const double enabled = buf[1], running = buf[2];
+        const double scale = running > 0 ? enabled / running : 0;
+        for (std::size_t i = 0; i < g.events.size() && i < buf[0]; ++i)
+            values[g.events[i]] = buf[3 + i] * scale;
+    }
+    return values;
+}
+
+std::string PerfCounters::header() {
+    return "ipc,cycles_elem,instr_elem,l1_miss_elem,llc_miss_elem,branch_miss_elem,tlb_miss_elem";
+}
+
+/*
+ * Colonnes CSV : instructions par cycle, puis chaque compte par élément.
+ * Un champ vide signale un compteur indisponible.
+ */
+std::string PerfCounters::csv(const std::vector<double>& values, std::size_t n) {
+    std::ostringstream out;
+    out.setf(std::ios::fixed);
+    out.precision(4);
+    auto field = [&](double v) {
+        if (!std::isnan(v))
+            out << v;
+    };
+    field(values[CYCLES] > 0 ? values[INSTRUCTIONS] / values[CYCLES] : NAN);
+    const double elems = n ? n : 1;
+    for (Event e : {CYCLES, INSTRUCTIONS, L1D_MISSES, LLC_MISSES, BRANCH_MISSES, DTLB_MISSES}) {
+        out << ",";
+        field(values[e] / elems);
+    }
+    return out.str();
+}
@@ -0,0 +1,56 @@
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+#include "radix.hpp"
+
+#pragma once
+
+// Le tri par dénombrement est choisi si l'étendue des valeurs ne dépasse pas
+// ce facteur fois le nombre d'éléments.
+const std::size_t COUNTING_RANGE_FACTOR = 4;
+
+/*
+ * Tri par dénombrement sur [lo, hi] : on compte chaque valeur, puis on
+ * réécrit le tableau dans l'ordre. Aucune comparaison entre éléments.
+ */
+template <typename T>
+void counting_sort(T* v, std::size_t n, T lo, T hi) {
+    using U = typename std::make_unsigned<T>::type;
+    const std::size_t range = static_cast<U>(static_cast<U>(hi) - static_cast<U>(lo)) + std::size_t(1);
+    std::vector<std::size_t> counts(range, 0);
+    for (std::size_t i = 0; i < n; ++i)
+        counts[static_cast<U>(static_cast<U>(v[i]) - static_cast<U>(lo))]++;
+
+    T* out = v;
+    for (std::size_t k = 0; k < range; ++k) {
+        out = std::fill_n(out, counts[k], static_cast<T>(static_cast<U>(lo) + k));
+    }
+}
+
+/*
+ * Une lecture pour trouver min et max ; si les valeurs sont denses (cas des
+ * permutations de gen.sh), on les place directement, sinon tri par base.
+ * Flottants et paires n'ont pas d'étendue dénombrable : tri par base direct.
+ */
+template <typename T>
+void auto_sort(T* v, std::size_t n) {
+    if (n < 2)
+        return;
+    if constexpr (!std::is_integral<T>::value) {
+        radix_sort(v, n);
+    } else {
+        auto lo = v[0], hi = v[0];
+        for (std::size_t i = 0; i < n; ++i) {
+            lo = std::min(lo, v[i]);
+            hi = std::max(hi, v[i]);
+        }
+
+        using U = typename std::make_unsigned<T>::type;
+        const U span = static_cast<U>(hi) - static_cast<U>(lo);
+        if (span / COUNTING_RANGE_FACTOR < n)
+            counting_sort(v, n, lo, hi);
+        else
+            radix_sort(v, n);
+    }
+}
@@ -0,0 +1,160 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "pdq.hpp"
+
+#pragma once
+
+// Sous cette taille, la tranche est finie par insertion.
+const std::ptrdiff_t DUP_INSERTION_SORT = 24;
+// Clés tirées pour estimer le nombre de valeurs distinctes.
+const std::size_t DUP_SAMPLE = 4096;
+// Au-delà de ce nombre de valeurs distinctes, le comptage est abandonné
+// (table de 2^17 cases, 2 Mo : elle tient encore en cache L2/L3).
+const unsigned int DUP_HASH_BITS = 17;
+const std::size_t DUP_HASH_MAX_DISTINCT = std::size_t(1) << (DUP_HASH_BITS - 1);
+
+/*
+ * Tri rapide à partition en trois (Bentley et McIlroy) : pendant le
+ * balayage, les clés égales au pivot sont rangées aux deux bouts, puis
+ * ramenées au milieu. Elles ne sont plus jamais revues, si bien que n clés
+ * à d valeurs distinctes coûtent O(n log d). Récursion sur la plus petite
+ * partie, boucle sur la plus grande ; tri par tas après 2 log2(n) niveaux.
+ */
+template <typename T>
+void dup_quicksort(T* a, std::ptrdiff_t n, int depth) {
+    while (n > DUP_INSERTION_SORT) {
+        if (depth-- == 0) {
+            std::make_heap(a, a + n);
+            std::sort_heap(a, a + n);
+            return;
+        }
+        pdq_sort3(a + n / 2, a, a + n - 1, std::less<T>());
+        const T v = a[0];
+
+        std::ptrdiff_t i = 0, j = n, p = 0, q = n;
+        while (true) {
+            while (a[++i] < v)
+                if (i == n - 1)
+                    break;
+            while (v < a[--j])
+                if (j == 0)
+                    break;
+            if (i == j && a[i] == v)
+                std::swap(a[++p], a[i]);
+            if (i >= j)
+                break;
+            std::swap(a[i], a[j]);
+            if (a[i] == v)
+                std::swap(a[++p], a[i]);
+            if (a[j] == v)
+                std::swap(a[--q], a[j]);
+        }
+        i = j + 1;
+        for (std::ptrdiff_t k = 0; k <= p; ++k)
+            std::swap(a[k], a[j--]);
+        for (std::ptrdiff_t k = n - 1; k >= q; --k)
+            std::swap(a[k], a[i++]);
+
+        // [0, j] plus petits, [i, n) plus grands.
+        if (j + 1 < n - i) {
+            dup_quicksort(a, j + 1, depth);
+            a += i;
+            n -= i;
+        } else {
+            dup_quicksort(a + i, n - i, depth);
+            n = j + 1;
+        }
+    }
+    pdq_insertion_sort(a, a + n, std::less<T>());
+}
+
+template <typename T>
+void quick3_sort(T* a, std::size_t n) {
+    int depth = 0;
+    for (std::size_t m = n; m > 1; m >>= 1)
+        depth += 2;
+    dup_quicksort(a, n, depth);
+}
+
+/*
+ * Comptage par hachage (adressage ouvert, sondage linéaire) : une lecture
+ * compte chaque valeur, on trie les d valeurs distinctes puis on réécrit le
+ * tableau. O(n + d log d). Renvoie faux, sans avoir modifié le tableau, si
+ * plus de DUP_HASH_MAX_DISTINCT valeurs distinctes apparaissent.
+ */
+template <typename T>
+bool hash_count_sort(T* a, std::size_t n) {
+    const std::size_t capacity = std::size_t(1) << DUP_HASH_BITS;
+    const unsigned int shift = 64 - DUP_HASH_BITS;
+    std::vector<std::pair<T, std::size_t>> table(capacity, {T(), 0});
+    std::size_t distinct = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        std::size_t h = (static_cast<std::uint64_t>(a[i]) * 0x9E3779B97F4A7C15ull) >> shift;
+        while (table[h].second != 0 && !(table[h].first == a[i]))
+            h = (h + 1) & (capacity - 1);
+        if (table[h].second++ == 0) {
+            table[h].first = a[i];
+            if (++distinct > DUP_HASH_MAX_DISTINCT)
+                return false;
+        }
+    }
+
+    auto last = std::remove_if(table.begin(), table.end(),
+                               [](const std::pair<T, std::size_t>& e) { return e.second == 0; });
+    std::sort(table.begin(), last);
+    T* out = a;
+    for (auto e = table.begin(); e != last; ++e)
+        out = std::fill_n(out, e->second, e->first);
+    return true;
+}
+
+/*
+ * Estimateur Chao1 du nombre de valeurs distinctes de la population d'après
+ * un échantillon : d + f1² / 2 f2, où d compte les valeurs distinctes de
+ * l'échantillon, f1 celles vues une fois et f2 celles vues deux fois.
+ * Beaucoup de valeurs vues une seule fois trahissent beaucoup de valeurs
+ * jamais vues.
+ */
+template <typename T>
+double estimate_distinct(std::vector<T>& sample) {
+    std::sort(sample.begin(), sample.end());
+    double d = 0, f1 = 0, f2 = 0;
+    for (std::size_t i = 0, j; i < sample.size(); i = j) {
+        for (j = i + 1; j < sample.size() && sample[j] == sample[i]; ++j)
+            ;
+        d += 1;
+        f1 += j - i == 1;
+        f2 += j - i == 2;
+    }
+    return f2 > 0 ? d + f1 * f1 / (2 * f2) : d + f1 * (f1 - 1) / 2;
+}
+
+/*
+ * Moteur pour entrées à doublons : si l'estimation tirée d'un échantillon
+ * promet peu de valeurs distinctes, comptage par hachage en O(n) ; sinon
+ * pdqsort, dont la partition sans branchement bat le tri en trois parties
+ * même avec beaucoup de doublons (sa partition « à gauche » regroupe déjà
+ * les clés égales à un pivot répété).
+ */
+template <typename T>
+void dup_sort(T* a, std::size_t n) {
+    // Le comptage ne garde qu'un représentant par valeur : entiers seulement
+    // (une paire perdrait sa charge utile, un flottant le signe de -0).
+    if constexpr (std::is_integral<T>::value) {
+        if (n >= DUP_SAMPLE) {
+            std::mt19937_64 rng(n);
+            std::vector<T> sample(DUP_SAMPLE);
+            for (auto& x : sample)
+                x = a[rng() % n];
+            if (estimate_distinct(sample) <= DUP_HASH_MAX_DISTINCT && hash_count_sort(a, n))
+                return;
+        }
+    }
+    pdqsort(a, a + n, std::less<T>());
+}
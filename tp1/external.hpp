@@ -0,0 +1,338 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include "io.hpp"
+#include "radix.hpp"
+
+#pragma once
+
+// Budget mémoire par défaut du tri externe, en Mio.
+const std::size_t EXTERNAL_DEFAULT_BUDGET_MB = 256;
+// En dessous, les morceaux seraient si petits que les séquences pulluleraient.
+const std::size_t EXTERNAL_MIN_BUDGET_MB = 1;
+// Séquences fusionnées au plus d'un coup : au-delà, fusions intermédiaires.
+// Borne aussi le nombre de fichiers temporaires ouverts.
+const std::size_t EXTERNAL_MAX_FANIN = 256;
+
+/*
+ * Fichier temporaire anonyme : il est supprimé du répertoire dès sa création
+ * et disparaît à la fermeture du descripteur.
+ */
+int make_temp_file() {
+    const char* dir = std::getenv("TMPDIR");
+    std::string path = std::string(dir ? dir : "/tmp") + "/sort_run_XXXXXX";
+    int fd = mkstemp(&path[0]);
+    if (fd < 0)
+        throw std::system_error(errno, std::generic_category(), "mkstemp");
+    unlink(path.c_str());
+    return fd;
+}
+
+void write_fully(int fd, const void* data, std::size_t size) {
+    auto p = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t n = write(fd, p, size);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            throw std::system_error(errno, std::generic_category(), "write");
+        }
+        p += n;
+        size -= n;
+    }
+}
+
+/*
+ * Lecture séquentielle d'une séquence triée déversée sur disque, par gros
+ * blocs lus d'avance.
+ */
+template <typename T>
+class RunReader
+{
+public:
+    RunReader(int fd, std::size_t bufferElems);
+    RunReader(RunReader&& other) noexcept;
+    ~RunReader();
+
+    bool done() const noexcept;
+    T peek() const noexcept;
+    void next();
+
+private:
+    void refill();
+
+    int fd;
+    std::vector<T> buffer;
+    std::size_t pos = 0;
+    std::size_t len = 0;
+};
+
+template <typename T>
+RunReader<T>::RunReader(int fd, std::size_t bufferElems)
+    : fd(fd),
+      buffer(std::max<std::size_t>(bufferElems, 1))
+{
+    lseek(fd, 0, SEEK_SET);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    refill();
+}
+
+template <typename T>
+RunReader<T>::RunReader(RunReader&& other) noexcept
+    : fd(other.fd),
+      buffer(std::move(other.buffer)),
+      pos(other.pos),
+      len(other.len)
+{
+    other.fd = -1;
+}
+
+template <typename T>
+RunReader<T>::~RunReader() {
+    if (fd >= 0)
+        close(fd);
+}
+
+template <typename T>
+bool RunReader<T>::done() const noexcept {
+    return pos == len;
+}
+
+template <typename T>
+T RunReader<T>::peek() const noexcept {
+    return buffer[pos];
+}
+
+template <typename T>
+void RunReader<T>::next() {
+    if (++pos == len)
+        refill();
+}
+
+template <typename T>
+void RunReader<T>::refill() {
+    auto p = reinterpret_cast<char*>(buffer.data());
+    std::size_t want = buffer.size() * sizeof(T);
+    std::size_t got = 0;
+    while (got < want) {
+        ssize_t n = read(fd, p + got, want - got);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            throw std::system_error(errno, std::generic_category(), "read");
+        }
+        if (n == 0)
+            break;
+        got += n;
+    }
+    pos = 0;
+    len = got / sizeof(T);
+}
+
+/*
+ * Arbre des perdants sur k séquences : chaque nœud interne garde le perdant
+ * de son match, la racine (tree[0]) le gagnant. Remplacer le gagnant ne
+ * rejoue qu'un chemin feuille-racine, soit log2(k) comparaisons.
+ */
+template <typename T>
+class LoserTree
+{
+public:
+    explicit LoserTree(std::vector<RunReader<T>>& runs);
+
+    bool empty() const noexcept;
+    T top() const noexcept;
+    void pop();
+
+private:
+    bool beats(std::size_t a, std::size_t b) const noexcept;
+    std::size_t build(std::size_t node);
+
+    std::vector<RunReader<T>>& runs;
+    std::vector<std::size_t> tree;
+};
+
+template <typename T>
+LoserTree<T>::LoserTree(std::vector<RunReader<T>>& runs)
+    : runs(runs),
+      tree(std::max<std::size_t>(runs.size(), 1))
+{
+    if (!runs.empty())
+        tree[0] = build(1);
+}
+
+template <typename T>
+bool LoserTree<T>::beats(std::size_t a, std::size_t b) const noexcept {
+    // Une séquence épuisée perd toujours ; à égalité, la plus ancienne gagne.
+    if (runs[a].done())
+        return false;
+    if (runs[b].done())
+        return true;
+    T x = runs[a].peek(), y = runs[b].peek();
+    return x < y || (!(y < x) && a < b);
+}
+
+template <typename T>
+std::size_t LoserTree<T>::build(std::size_t node) {
+    const std::size_t k = runs.size();
+    if (node >= k)
+        return node - k;
+    std::size_t l = build(2 * node);
+    std::size_t r = build(2 * node + 1);
+    if (beats(l, r)) {
+        tree[node] = r;
+        return l;
+    }
+    tree[node] = l;
+    return r;
+}
+
+template <typename T>
+bool LoserTree<T>::empty() const noexcept {
+    return runs.empty() || runs[tree[0]].done();
+}
+
+template <typename T>
+T LoserTree<T>::top() const noexcept {
+    return runs[tree[0]].peek();
+}
+
+template <typename T>
+void LoserTree<T>::pop() {
+    std::size_t winner = tree[0];
+    runs[winner].next();
+    for (std::size_t node = (winner + runs.size()) / 2; node > 0; node /= 2) {
+        if (beats(tree[node], winner))
+            std::swap(tree[node], winner);
+    }
+    tree[0] = winner;
+}
+
+/*
+ * Fusionne les séquences des descripteurs fds (qui sont refermés) et passe
+ * chaque clé, dans l'ordre, à emit. Le budget est partagé entre les tampons
+ * de lecture et, en réserve, une part pour l'écriture de l'appelant.
+ */
+template <typename T, typename F>
+void merge_runs(std::vector<int>& fds, std::size_t budgetBytes, F emit) {
+    const std::size_t readElems = budgetBytes / sizeof(T) / (fds.size() + 1);
+    std::vector<RunReader<T>> runs;
+    runs.reserve(fds.size());
+    for (int fd : fds)
+        runs.emplace_back(fd, readElems);
+    fds.clear();
+
+    LoserTree<T> tree(runs);
+    while (!tree.empty()) {
+        emit(tree.top());
+        tree.pop();
+    }
+}
+
+// Fusion intermédiaire : les séquences de fds n'en forment plus qu'une.
+template <typename T>
+int merge_to_file(std::vector<int>& fds, std::size_t budgetBytes) {
+    int out = make_temp_file();
+    std::vector<T> block;
+    block.reserve(std::max<std::size_t>(budgetBytes / sizeof(T) / (fds.size() + 1), 1));
+    merge_runs<T>(fds, budgetBytes, [&](const T& x) {
+        block.push_back(x);
+        if (block.size() == block.capacity()) {
+            write_fully(out, block.data(), block.size() * sizeof(T));
+            block.clear();
+        }
+    });
+    write_fully(out, block.data(), block.size() * sizeof(T));
+    return out;
+}
+
+/*
+ * Tri externe : l'entrée, texte ou binaire (voir stream_numbers), est lue
+ * par morceaux qui tiennent dans le budget, chaque morceau est trié en
+ * mémoire (tri par base, qui demande un tampon de même taille) et déversé
+ * dans un fichier temporaire, puis les séquences sont fusionnées par un
+ * arbre des perdants vers la sortie standard.
+ * Les séquences sont rangées par niveaux : dès qu'un niveau en compte
+ * EXTERNAL_MAX_FANIN, elles sont fusionnées en une seule au niveau suivant.
+ * Chaque clé n'est ainsi relue que log_256 fois, et il n'y a jamais plus de
+ * EXTERNAL_MAX_FANIN fichiers ouverts par niveau.
+ */
+template <typename T>
+void external_sort(const std::string& path, std::size_t budgetBytes,
+                   bool print, bool binary, bool zeroCopy) {
+    if (budgetBytes < (EXTERNAL_MIN_BUDGET_MB << 20))
+        throw std::invalid_argument("budget du tri externe inférieur à " +
+                                    std::to_string(EXTERNAL_MIN_BUDGET_MB) + " Mio");
+
+    std::vector<std::vector<int>> levels;
+    auto addRun = [&](int fd) {
+        for (std::size_t l = 0;; ++l) {
+            if (levels.size() == l)
+                levels.emplace_back();
+            levels[l].push_back(fd);
+            if (levels[l].size() < EXTERNAL_MAX_FANIN)
+                return;
+            fd = merge_to_file<T>(levels[l], budgetBytes);
+        }
+    };
+
+    // Le tri par base utilise deux tableaux de la taille d'un morceau.
+    const std::size_t runElems = std::max<std::size_t>(budgetBytes / (2 * sizeof(T)), 1);
+    {
+        std::vector<T> run;
+        run.reserve(runElems);
+        auto spill = [&] {
+            radix_sort(run);
+            int fd = make_temp_file();
+            write_fully(fd, run.data(), run.size() * sizeof(T));
+            addRun(fd);
+            run.clear();
+        };
+        stream_numbers<T>(path, [&](const T* values, std::size_t n) {
+            while (n > 0) {
+                std::size_t take = std::min(n, runElems - run.size());
+                run.insert(run.end(), values, values + take);
+                values += take;
+                n -= take;
+                if (run.size() == runElems)
+                    spill();
+            }
+        });
+        if (!run.empty())
+            spill();
+    }
+
+    // Fusion finale de tous les niveaux, ramenés chacun à une séquence si
+    // ensemble ils dépassent la largeur de fusion.
+    std::vector<int> runFiles;
+    for (auto& level : levels)
+        runFiles.insert(runFiles.end(), level.begin(), level.end());
+    if (runFiles.size() > EXTERNAL_MAX_FANIN) {
+        runFiles.clear();
+        for (auto& level : levels) {
+            if (level.size() > 1)
+                runFiles.push_back(merge_to_file<T>(level, budgetBytes));
+            else if (level.size() == 1)
+                runFiles.push_back(level[0]);
+        }
+    }
+
+    if (!print) {
+        merge_runs<T>(runFiles, budgetBytes, [](const T&) {});
+        return;
+    }
+    OutputWriter writer(STDOUT_FILENO, zeroCopy);
+    merge_runs<T>(runFiles, budgetBytes, [&](const T& x) {
+        if (binary)
+            writer.bytes(&x, sizeof(T));
+        else
+            writer.text(x);
+    });
+}
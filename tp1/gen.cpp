@@ -0,0 +1,226 @@
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include "io.hpp"
+#include "pool.hpp"
+
+/*
+ * Générateur de jeux de données reproductibles pour sort :
+ *   g++ -std=c++17 -O3 -pthread gen.cpp -o gen
+ *   ./gen -d distribution -n taille [-s graine] [-k param] [-z exposant] [-b] [-o fichier]
+ * La même graine donne toujours le même fichier. Sortie texte (une valeur
+ * par ligne) ou binaire (-b, format de sort convert).
+ */
+
+using Int = long long;
+
+// Nombre de valeurs formatées par tâche en sortie texte.
+const std::size_t GEN_BLOCK = std::size_t(1) << 16;
+// Valeurs distinctes (fewunique) ou dents (sawtooth) par défaut.
+const std::size_t GEN_DEFAULT_K = 16;
+
+/*
+ * Loi de Zipf sur {1, ..., n} : P(k) proportionnel à 1 / k^s.
+ * Échantillonnage par rejet-inversion (Hörmann et Derflinger, 1996) :
+ * temps constant par tirage, sans table de n probabilités.
+ */
+class ZipfDistribution
+{
+public:
+    ZipfDistribution(Int n, double s);
+
+    template <typename Rng>
+    Int operator()(Rng& rng);
+
+private:
+    double h(double x) const;
+    double hIntegral(double x) const;
+    double hIntegralInverse(double x) const;
+    static double log1pOverX(double x);
+    static double expm1OverX(double x);
+
+    Int n;
+    double s;
+    double hIntegralX1;
+    double hIntegralN;
+    double threshold;
+};
+
+ZipfDistribution::ZipfDistribution(Int n, double s)
+    : n(n),
+      s(s),
+      hIntegralX1(hIntegral(1.5) - 1),
+      hIntegralN(hIntegral(n + 0.5)),
+      threshold(2 - hIntegralInverse(hIntegral(2.5) - h(2)))
+{}
+
+template <typename Rng>
+Int ZipfDistribution::operator()(Rng& rng) {
+    std::uniform_real_distribution<double> uniform(0, 1);
+    while (true) {
+        double u = hIntegralN + uniform(rng) * (hIntegralX1 - hIntegralN);
+        double x = hIntegralInverse(u);
+        Int k = std::min(std::max(static_cast<Int>(x + 0.5), Int(1)), n);
+        if (k - x <= threshold || u >= hIntegral(k + 0.5) - h(k))
+            return k;
+    }
+}
+
+double ZipfDistribution::h(double x) const {
+    return std::exp(-s * std::log(x));
+}
+
+double ZipfDistribution::hIntegral(double x) const {
+    double logX = std::log(x);
+    return expm1OverX((1 - s) * logX) * logX;
+}
+
+double ZipfDistribution::hIntegralInverse(double x) const {
+    double t = std::max(x * (1 - s), -1.0);
+    return std::exp(log1pOverX(t) * x);
+}
+
+// log(1 + x) / x, prolongée par continuité en 0.
+double ZipfDistribution::log1pOverX(double x) {
+    if (std::abs(x) > 1e-8)
+        return std::log1p(x) / x;
+    return 1 - x / 2;
+}
+
+// (exp(x) - 1) / x, prolongée par continuité en 0.
+double ZipfDistribution::expm1OverX(double x) {
+    if (std::abs(x) > 1e-8)
+        return std::expm1(x) / x;
+    return 1 + x / 2;
+}
+
+/*
+ * Remplit v selon la distribution demandée ; renvoie faux si elle est inconnue.
+ * random : permutation de 1..n (comme shuf -i 1-n) ; sorted, reversed ;
+ * organ : croissant puis décroissant ; fewunique : k valeurs tirées
+ * uniformément ; zipf : rangs de 1..n biaisés vers les petits ;
+ * sawtooth : k dents croissantes.
+ */
+bool generate(const std::string& dist, std::vector<Int>& v, std::uint64_t seed,
+              std::size_t k, double exponent) {
+    const std::size_t n = v.size();
+    k = std::max<std::size_t>(k, 1);
+    std::mt19937_64 rng(seed);
+    if (dist == "random") {
+        std::iota(v.begin(), v.end(), Int(1));
+        std::shuffle(v.begin(), v.end(), rng);
+    } else if (dist == "sorted") {
+        std::iota(v.begin(), v.end(), Int(1));
+    } else if (dist == "reversed") {
+        for (std::size_t i = 0; i < n; ++i)
+            v[i] = n - i;
+    } else if (dist == "organ") {
+        for (std::size_t i = 0; i < n; ++i)
+            v[i] = i < (n + 1) / 2 ? i + 1 : n - i;
+    } else if (dist == "fewunique") {
+        std::uniform_int_distribution<Int> values(1, k);
+        for (auto& x : v)
+            x = values(rng);
+    } else if (dist == "zipf") {
+        ZipfDistribution zipf(std::max<std::size_t>(n, 1), exponent);
+        for (auto& x : v)
+            x = zipf(rng);
+    } else if (dist == "sawtooth") {
+        const std::size_t tooth = std::max<std::size_t>((n + k - 1) / k, 1);
+        for (std::size_t i = 0; i < n; ++i)
+            v[i] = i % tooth + 1;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/*
+ * Sortie texte : chaque tâche formate un bloc de GEN_BLOCK valeurs dans son
+ * propre tampon, puis les tampons sont écrits dans l'ordre.
+ */
+void write_text(const std::vector<Int>& v, OutputWriter& out) {
+    const std::size_t parts = ThreadPool::global().size();
+    std::vector<std::vector<char>> buffers(parts, std::vector<char>(GEN_BLOCK * 21));
+    std::vector<std::size_t> used(parts);
+    for (std::size_t base = 0; base < v.size(); base += parts * GEN_BLOCK) {
+        TaskGroup group;
+        for (std::size_t p = 0; p < parts; ++p)
+            group.run([&, p] {
+                std::size_t first = std::min(base + p * GEN_BLOCK, v.size());
+                std::size_t last = std::min(first + GEN_BLOCK, v.size());
+                char* pos = buffers[p].data();
+                for (std::size_t i = first; i < last; ++i) {
+                    pos = std::to_chars(pos, pos + 20, v[i]).ptr;
+                    *pos++ = '\n';
+                }
+                used[p] = pos - buffers[p].data();
+            });
+        group.wait();
+        for (std::size_t p = 0; p < parts; ++p)
+            out.bytes(buffers[p].data(), used[p]);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    std::string dist = "random";
+    std::size_t n = 0;
+    std::uint64_t seed = 1;
+    std::size_t k = GEN_DEFAULT_K;
+    double exponent = 1.0;
+    bool binary = false;
+    std::string path;
+
+    // Read program arguments
+    for (int i=1; i<argc; i++) {
+        std::string arg(argv[i]);
+        if (arg == "-d") {
+            dist = argv[i+1]; i++;
+        } else if (arg == "-n") {
+            n = std::stoull(argv[i+1]); i++;
+        } else if (arg == "-s") {
+            seed = std::stoull(argv[i+1]); i++;
+        } else if (arg == "-k") {
+            k = std::stoull(argv[i+1]); i++;
+        } else if (arg == "-z") {
+            exponent = std::stod(argv[i+1]); i++;
+        } else if (arg == "-b") {
+            binary = true;
+        } else if (arg == "-o") {
+            path = argv[i+1]; i++;
+        }
+    }
+
+    std::vector<Int> values(n);
+    if (!generate(dist, values, seed, k, exponent)) {
+        std::cerr << "distribution inconnue : " << dist << std::endl;
+        return 1;
+    }
+
+    int fd = STDOUT_FILENO;
+    if (!path.empty() && (fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644)) < 0) {
+        perror(path.c_str());
+        return 1;
+    }
+    {
+        OutputWriter out(fd, false);
+        if (binary) {
+            auto header = binary_header<Int>(values.size());
+            out.bytes(&header, sizeof(header));
+            out.bytes(values.data(), values.size() * sizeof(Int));
+        } else {
+            write_text(values, out);
+        }
+    }
+    if (fd != STDOUT_FILENO)
+        close(fd);
+}
@@ -1,6 +1,16 @@
 #!/bin/bash
-for n in {"1000","5000","10000","50000","100000","500000"}; do
-	for i in {1..10}; do
-		shuf -i 1-$n > testset_${n}_${i}.txt
+# Jeux de données de ./gen (voir gen.cpp), une graine par répétition :
+# testset_<distribution>_<taille>_<i>
+# -b : jeux au format binaire (voir sort convert), sans texte à analyser
+ext=txt
+if [ "$1" == "-b" ]; then
+	ext=bin
+	binary=-b
+fi
+for d in random sorted reversed organ fewunique zipf sawtooth; do
+	for n in {"1000","5000","10000","50000","100000","500000"}; do
+		for i in {1..10}; do
+			./gen -d $d -n $n -s $i $binary -o testset_${d}_${n}_${i}.$ext
+		done
 	done
 done
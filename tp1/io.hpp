@@ -0,0 +1,667 @@
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include "keys.hpp"
+#include "pool.hpp"
+
+#pragma once
+
+// Au-delà de cette taille, le fichier est découpé et analysé en parallèle.
+const std::size_t LOAD_PARALLEL_BYTES = std::size_t(64) << 20;
+
+/*
+ * Projection en lecture seule d'un fichier complet. Un fichier vide donne
+ * une projection vide ; un fichier illisible lève std::system_error.
+ */
+class MappedFile
+{
+public:
+    explicit MappedFile(const std::string& path);
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile();
+
+    const char* data() const noexcept;
+    std::size_t size() const noexcept;
+
+private:
+    const char* addr = nullptr;
+    std::size_t length = 0;
+};
+
+MappedFile::MappedFile(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::system_error(errno, std::generic_category(), path);
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        int err = errno;
+        close(fd);
+        throw std::system_error(err, std::generic_category(), path);
+    }
+    if (st.st_size > 0) {
+        void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            int err = errno;
+            close(fd);
+            throw std::system_error(err, std::generic_category(), path);
+        }
+        madvise(p, st.st_size, MADV_SEQUENTIAL);
+        addr = static_cast<const char*>(p);
+        length = st.st_size;
+    }
+    close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if (addr)
+        munmap(const_cast<char*>(addr), length);
+}
+
+const char* MappedFile::data() const noexcept {
+    return addr;
+}
+
+std::size_t MappedFile::size() const noexcept {
+    return length;
+}
+
+// memchr est vectorisé par la libc : c'est notre balayage SIMD.
+std::size_t count_lines(const char* first, const char* last) {
+    std::size_t lines = 0;
+    while ((first = static_cast<const char*>(memchr(first, '\n', last - first)))) {
+        ++lines;
+        ++first;
+    }
+    return lines;
+}
+
+// Lit une clé en tête de [first, last), comme std::from_chars.
+template <typename T>
+std::from_chars_result parse_key(const char* first, const char* last, T& value) {
+    return std::from_chars(first, last, value);
+}
+
+// Une paire s'écrit « clé charge » sur sa ligne ; sans charge, elle vaut 0.
+std::from_chars_result parse_key(const char* first, const char* last, KeyPair& value) {
+    auto res = std::from_chars(first, last, value.key);
+    if (res.ec != std::errc())
+        return res;
+    const char* p = res.ptr;
+    while (p < last && (*p == ' ' || *p == '\t' || *p == ','))
+        ++p;
+    value.value = 0;
+    auto payload = std::from_chars(p, last, value.value);
+    if (payload.ec == std::errc())
+        res.ptr = payload.ptr;
+    return res;
+}
+
+// Écrit une clé dans [first, last), comme std::to_chars ; renvoie la fin.
+template <typename T>
+char* format_key(char* first, char* last, T value) {
+    return std::to_chars(first, last, value).ptr;
+}
+
+char* format_key(char* first, char* last, const KeyPair& value) {
+    first = std::to_chars(first, last, value.key).ptr;
+    *first++ = ' ';
+    return std::to_chars(first, last, value.value).ptr;
+}
+
+/*
+ * Analyse les clés de [first, last) vers [out, outEnd) et s'arrête quand la
+ * sortie est pleine ; renvoie la position atteinte dans l'entrée et avance out.
+ * Une ligne illisible est ignorée, comme un séparateur.
+ */
+template <typename T>
+const char* parse_some(const char* first, const char* last, T*& out, T* outEnd) {
+    while (first < last && out < outEnd) {
+        while (first < last && (*first == '\n' || *first == ' ' ||
+                                *first == '\r' || *first == '\t'))
+            ++first;
+        if (first == last)
+            break;
+        if (*first == '+')
+            ++first;
+        auto res = parse_key(first, last, *out);
+        if (res.ec == std::errc()) {
+            ++out;
+            first = res.ptr;
+        } else {
+            auto eol = static_cast<const char*>(memchr(first, '\n', last - first));
+            first = eol ? eol : last;
+        }
+    }
+    return first;
+}
+
+/*
+ * Format binaire des jeux de données : un en-tête de 64 octets (une ligne de
+ * cache, les clés qui suivent restent alignées) donnant le nombre de clés et
+ * leur largeur et nature, puis les clés brutes en little-endian (l'ordre natif ici).
+ */
+const char BINARY_MAGIC[8] = {'T', 'R', 'I', 'B', 'I', 'N', '0', '1'};
+
+struct BinaryHeader {
+    char magic[8];
+    std::uint64_t count;
+    std::uint32_t width;
+    char kind;
+    char reserved[43];
+};
+static_assert(sizeof(BinaryHeader) == 64, "l'en-tête occupe une ligne de cache");
+
+/*
+ * Nature des clés, pour distinguer des types de même largeur : 'i' entier
+ * signé, 'u' non signé, 'f' flottant, 'p' paire. 0 (fichiers plus anciens)
+ * est accepté pour tous.
+ */
+template <typename T>
+char key_kind() {
+    if (std::is_floating_point<T>::value)
+        return 'f';
+    if (!std::is_integral<T>::value)
+        return 'p';
+    return std::is_signed<T>::value ? 'i' : 'u';
+}
+
+template <typename T>
+BinaryHeader binary_header(std::size_t count) {
+    BinaryHeader header{};
+    memcpy(header.magic, BINARY_MAGIC, sizeof(BINARY_MAGIC));
+    header.count = count;
+    header.width = sizeof(T);
+    header.kind = key_kind<T>();
+    return header;
+}
+
+// Vérifie que l'en-tête décrit des clés de type T.
+template <typename T>
+void check_key_type(const BinaryHeader& header, const std::string& path) {
+    if (header.width != sizeof(T))
+        throw std::runtime_error(path + " : clés de " + std::to_string(header.width) +
+                                 " octets, " + std::to_string(sizeof(T)) + " attendus");
+    if (header.kind && header.kind != key_kind<T>())
+        throw std::runtime_error(path + " : clés de nature '" + header.kind +
+                                 "', '" + key_kind<T>() + "' attendue (voir --type)");
+}
+
+bool is_binary(const char* data, std::size_t size) {
+    return size >= sizeof(BinaryHeader) && memcmp(data, BINARY_MAGIC, sizeof(BINARY_MAGIC)) == 0;
+}
+
+bool is_binary_file(const std::string& path) {
+    char magic[sizeof(BINARY_MAGIC)];
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    bool binary = pread(fd, magic, sizeof(magic), 0) == sizeof(magic) &&
+                  memcmp(magic, BINARY_MAGIC, sizeof(magic)) == 0;
+    close(fd);
+    return binary;
+}
+
+// Vérifie que l'en-tête décrit bien des clés de type T présentes en entier.
+template <typename T>
+std::size_t binary_count(const char* data, std::size_t size, const std::string& path) {
+    BinaryHeader header;
+    memcpy(&header, data, sizeof(header));
+    check_key_type<T>(header, path);
+    if (header.count > (size - sizeof(header)) / sizeof(T))
+        throw std::runtime_error(path + " : fichier tronqué");
+    return header.count;
+}
+
+/*
+ * Projection inscriptible des clés d'un fichier binaire, triées sur place
+ * sans analyse ni copie dans un vecteur. Par défaut la projection est privée
+ * (copie à l'écriture) et le fichier reste intact ; avec inPlace elle est
+ * partagée et le fichier lui-même ressort trié. Les pages sont chargées dès
+ * la projection (MAP_POPULATE) pour que le tri ne mesure pas les défauts de page.
+ */
+template <typename T>
+class MappedKeys
+{
+public:
+    MappedKeys(const std::string& path, bool inPlace);
+    MappedKeys(const MappedKeys&) = delete;
+    MappedKeys& operator=(const MappedKeys&) = delete;
+    ~MappedKeys();
+
+    T* data() const noexcept;
+    std::size_t size() const noexcept;
+
+private:
+    char* addr = nullptr;
+    std::size_t length = 0;
+    std::size_t count = 0;
+};
+
+template <typename T>
+MappedKeys<T>::MappedKeys(const std::string& path, bool inPlace) {
+    int fd = open(path.c_str(), inPlace ? O_RDWR : O_RDONLY);
+    if (fd < 0)
+        throw std::system_error(errno, std::generic_category(), path);
+    struct stat st;
+    if (fstat(fd, &st) < 0 || st.st_size < static_cast<off_t>(sizeof(BinaryHeader))) {
+        close(fd);
+        throw std::runtime_error(path + " : pas un fichier binaire");
+    }
+    void* p = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE,
+                   (inPlace ? MAP_SHARED : MAP_PRIVATE) | MAP_POPULATE, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED)
+        throw std::system_error(errno, std::generic_category(), "mmap");
+    addr = static_cast<char*>(p);
+    length = st.st_size;
+    if (!is_binary(addr, length)) {
+        munmap(addr, length);
+        throw std::runtime_error(path + " : pas un fichier binaire");
+    }
+    count = binary_count<T>(addr, length, path);
+}
+
+template <typename T>
+MappedKeys<T>::~MappedKeys() {
+    munmap(addr, length);
+}
+
+template <typename T>
+T* MappedKeys<T>::data() const noexcept {
+    return reinterpret_cast<T*>(addr + sizeof(BinaryHeader));
+}
+
+template <typename T>
+std::size_t MappedKeys<T>::size() const noexcept {
+    return count;
+}
+
+/*
+ * Charge un fichier texte de clés, une par ligne (ou plusieurs séparées par
+ * des blancs). Le vecteur est dimensionné une seule fois d'après le nombre de
+ * lignes. Les gros fichiers sont coupés aux fins de ligne et chaque morceau
+ * est compté puis analysé par sa propre tâche, directement à sa place dans
+ * le vecteur.
+ * Un fichier binaire (voir BinaryHeader) est simplement recopié.
+ */
+template <typename T>
+std::vector<T> load_numbers(const std::string& path) {
+    std::vector<T> numbers;
+    MappedFile file(path);
+    const char* begin = file.data();
+    const char* end = begin + file.size();
+    if (!begin)
+        return numbers;
+    if (is_binary(begin, file.size())) {
+        numbers.resize(binary_count<T>(begin, file.size(), path));
+        memcpy(numbers.data(), begin + sizeof(BinaryHeader), numbers.size() * sizeof(T));
+        return numbers;
+    }
+
+    std::size_t parts = 1;
+    if (file.size() >= LOAD_PARALLEL_BYTES)
+        parts = ThreadPool::global().size();
+
+    std::vector<const char*> bounds(parts + 1);
+    bounds[0] = begin;
+    bounds[parts] = end;
+    for (std::size_t p = 1; p < parts; ++p) {
+        const char* cut = begin + file.size() * p / parts;
+        cut = std::max(cut, bounds[p - 1]);
+        auto eol = static_cast<const char*>(memchr(cut, '\n', end - cut));
+        bounds[p] = eol ? eol + 1 : end;
+    }
+
+    // Une valeur par ligne au plus, plus une éventuelle dernière ligne sans '\n'.
+    std::vector<std::size_t> offsets(parts + 1, 0);
+    {
+        TaskGroup group;
+        for (std::size_t p = 0; p < parts; ++p)
+            group.run([&, p] {
+                offsets[p + 1] = count_lines(bounds[p], bounds[p + 1]) + 1;
+            });
+        group.wait();
+    }
+    for (std::size_t p = 0; p < parts; ++p)
+        offsets[p + 1] += offsets[p];
+
+    // Une ligne peut porter plusieurs valeurs séparées par des blancs : ce qui
+    // ne tient plus dans la place du morceau est analysé à part, puis rejoint.
+    numbers.resize(offsets[parts]);
+    std::vector<std::size_t> counts(parts);
+    std::vector<std::vector<T>> overflow(parts);
+    {
+        TaskGroup group;
+        for (std::size_t p = 0; p < parts; ++p)
+            group.run([&, p] {
+                T* first = numbers.data() + offsets[p];
+                T* out = first;
+                const char* in = parse_some(bounds[p], bounds[p + 1], out, numbers.data() + offsets[p + 1]);
+                counts[p] = out - first;
+                while (in < bounds[p + 1]) {
+                    auto& extra = overflow[p];
+                    std::size_t used = extra.size();
+                    extra.resize(used + std::max<std::size_t>(used, 1024));
+                    T* more = extra.data() + used;
+                    in = parse_some(in, bounds[p + 1], more, extra.data() + extra.size());
+                    extra.resize(more - extra.data());
+                }
+            });
+        group.wait();
+    }
+
+    // Refermer les trous laissés par les lignes vides ou illisibles.
+    std::size_t size = counts[0];
+    for (std::size_t p = 1; p < parts; ++p) {
+        if (size != offsets[p])
+            std::copy(numbers.begin() + offsets[p],
+                      numbers.begin() + offsets[p] + counts[p],
+                      numbers.begin() + size);
+        size += counts[p];
+    }
+    numbers.resize(size);
+
+    // Rare : réinsérer les valeurs en trop derrière celles de leur morceau.
+    std::size_t extras = 0;
+    for (auto& extra : overflow)
+        extras += extra.size();
+    if (extras > 0) {
+        std::vector<T> joined;
+        joined.reserve(size + extras);
+        std::size_t pos = 0;
+        for (std::size_t p = 0; p < parts; ++p) {
+            joined.insert(joined.end(), numbers.begin() + pos, numbers.begin() + pos + counts[p]);
+            joined.insert(joined.end(), overflow[p].begin(), overflow[p].end());
+            pos += counts[p];
+        }
+        numbers.swap(joined);
+    }
+    return numbers;
+}
+
+// Nombre de clés remises à la fois par stream_numbers.
+const std::size_t STREAM_CHUNK = 4096;
+// Taille des lectures de stream_numbers.
+const std::size_t STREAM_READ_BYTES = std::size_t(1) << 20;
+
+/*
+ * Parcourt un fichier texte ou binaire comme un flux : f(valeurs, nombre) est
+ * appelée sur des blocs successifs d'au plus STREAM_CHUNK clés. Le fichier
+ * est lu par blocs de taille fixe ; la fin incomplète d'un bloc (ligne ou clé
+ * coupée) est reportée au début du suivant. La mémoire utilisée ne dépend
+ * donc pas de la taille du fichier. Renvoie le nombre de clés lues.
+ */
+template <typename T, typename F>
+std::size_t stream_numbers(const std::string& path, F f) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return 0;
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    std::vector<char> block(STREAM_READ_BYTES);
+    std::size_t used = 0;
+    bool eof = false;
+    auto fill = [&] {
+        while (!eof && used < block.size()) {
+            ssize_t n = read(fd, block.data() + used, block.size() - used);
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n <= 0)
+                eof = true;
+            else
+                used += n;
+        }
+    };
+
+    fill();
+    std::size_t count = 0;
+    if (is_binary(block.data(), used)) {
+        BinaryHeader header;
+        memcpy(&header, block.data(), sizeof(header));
+        try {
+            check_key_type<T>(header, path);
+        } catch (...) {
+            close(fd);
+            throw;
+        }
+        std::size_t skip = sizeof(header);
+        T chunk[STREAM_CHUNK];
+        while (count < header.count && used > skip) {
+            std::size_t n = std::min({(used - skip) / sizeof(T), STREAM_CHUNK,
+                                      static_cast<std::size_t>(header.count - count)});
+            if (n == 0) {
+                if (eof)
+                    break;
+            } else {
+                // Copie pour l'alignement : le bloc lu n'est aligné que sur un octet.
+                memcpy(chunk, block.data() + skip, n * sizeof(T));
+                f(static_cast<const T*>(chunk), n);
+                count += n;
+                skip += n * sizeof(T);
+            }
+            if (used - skip < sizeof(T) * STREAM_CHUNK && !eof) {
+                memmove(block.data(), block.data() + skip, used - skip);
+                used -= skip;
+                skip = 0;
+                fill();
+            }
+        }
+        close(fd);
+        return count;
+    }
+
+    T chunk[STREAM_CHUNK];
+    while (used > 0) {
+        // Seules les lignes complètes sont analysées, sauf à la fin du fichier.
+        const char* first = block.data();
+        const char* last = first + used;
+        if (!eof) {
+            auto eol = static_cast<const char*>(memrchr(first, '\n', used));
+            if (eol)
+                last = eol + 1;
+        }
+        while (first < last) {
+            T* out = chunk;
+            first = parse_some(first, last, out, chunk + STREAM_CHUNK);
+            if (out > chunk)
+                f(static_cast<const T*>(chunk), static_cast<std::size_t>(out - chunk));
+            count += out - chunk;
+        }
+        used = block.data() + used - last;
+        memmove(block.data(), last, used);
+        if (eof)
+            break;
+        fill();
+    }
+    close(fd);
+    return count;
+}
+
+// Taille des blocs écrits d'un seul appel système.
+const std::size_t OUTPUT_BUFFER_BYTES = std::size_t(1) << 20;
+
+/*
+ * Écriture en gros blocs sur un descripteur. Les clés sont formatées avec
+ * to_chars dans un tampon réutilisé, vidé par de rares appels à write.
+ * En mode zeroCopy, si la sortie est un tube, chaque bloc plein est donné au
+ * noyau avec vmsplice puis remplacé par un bloc neuf : le tube référence les
+ * pages, qui ne doivent donc plus jamais être modifiées.
+ */
+class OutputWriter
+{
+public:
+    OutputWriter(int fd, bool zeroCopy);
+    OutputWriter(const OutputWriter&) = delete;
+    OutputWriter& operator=(const OutputWriter&) = delete;
+    ~OutputWriter();
+
+    template <typename T>
+    void text(T value);
+    void bytes(const void* data, std::size_t size);
+    void flush();
+
+private:
+    static char* allocate();
+    void writeAll(const char* data, std::size_t size);
+    bool spliceAll(const char* data, std::size_t size);
+
+    int fd;
+    bool splice = false;
+    char* buffer;
+    std::size_t used = 0;
+};
+
+OutputWriter::OutputWriter(int fd, bool zeroCopy)
+    : fd(fd),
+      buffer(allocate())
+{
+    struct stat st;
+    if (zeroCopy && fstat(fd, &st) == 0 && S_ISFIFO(st.st_mode)) {
+        splice = true;
+        // Un tube plus grand évite de bloquer à chaque bloc (échec sans gravité).
+        fcntl(fd, F_SETPIPE_SZ, static_cast<int>(OUTPUT_BUFFER_BYTES));
+    }
+}
+
+OutputWriter::~OutputWriter() {
+    flush();
+    munmap(buffer, OUTPUT_BUFFER_BYTES);
+}
+
+char* OutputWriter::allocate() {
+    void* p = mmap(nullptr, OUTPUT_BUFFER_BYTES, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED)
+        throw std::bad_alloc();
+    return static_cast<char*>(p);
+}
+
+template <typename T>
+void OutputWriter::text(T value) {
+    // Une paire de 64 bits (deux fois 20 chiffres et un signe), un séparateur
+    // et une fin de ligne au plus ; un double tient en 24 caractères.
+    if (OUTPUT_BUFFER_BYTES - used < 64)
+        flush();
+    char* end = format_key(buffer + used, buffer + OUTPUT_BUFFER_BYTES, value);
+    *end = '\n';
+    used = end + 1 - buffer;
+}
+
+void OutputWriter::bytes(const void* data, std::size_t size) {
+    auto p = static_cast<const char*>(data);
+    if (!splice && size >= OUTPUT_BUFFER_BYTES) {
+        // Inutile de recopier un gros bloc dans le tampon.
+        flush();
+        writeAll(p, size);
+        return;
+    }
+    while (size > 0) {
+        std::size_t n = std::min(size, OUTPUT_BUFFER_BYTES - used);
+        memcpy(buffer + used, p, n);
+        used += n;
+        p += n;
+        size -= n;
+        if (used == OUTPUT_BUFFER_BYTES)
+            flush();
+    }
+}
+
+void OutputWriter::flush() {
+    if (used == 0)
+        return;
+    if (!splice) {
+        writeAll(buffer, used);
+    } else if (spliceAll(buffer, used)) {
+        munmap(buffer, OUTPUT_BUFFER_BYTES);
+        buffer = allocate();
+    }
+    used = 0;
+}
+
+void OutputWriter::writeAll(const char* data, std::size_t size) {
+    while (size > 0) {
+        ssize_t n = write(fd, data, size);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            return;
+        }
+        data += n;
+        size -= n;
+    }
+}
+
+// Renvoie vrai si au moins une partie du bloc est référencée par le tube.
+bool OutputWriter::spliceAll(const char* data, std::size_t size) {
+    bool given = false;
+    while (size > 0) {
+        struct iovec iov{const_cast<char*>(data), size};
+        ssize_t n = vmsplice(fd, &iov, 1, 0);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            // vmsplice refusé : on se rabat sur write pour le reste.
+            splice = false;
+            writeAll(data, size);
+            break;
+        }
+        given = true;
+        data += n;
+        size -= n;
+    }
+    return given;
+}
+
+/*
+ * Écrit les nombres triés sur la sortie standard, en texte (un par ligne)
+ * ou en binaire brut (little-endian, largeur native).
+ */
+template <typename T>
+void write_numbers(const T* numbers, std::size_t n, bool binary, bool zeroCopy) {
+    OutputWriter out(STDOUT_FILENO, zeroCopy);
+    if (binary) {
+        out.bytes(numbers, n * sizeof(T));
+    } else {
+        for (std::size_t i = 0; i < n; ++i)
+            out.text(numbers[i]);
+    }
+}
+
+template <typename T>
+void write_numbers(const std::vector<T>& numbers, bool binary, bool zeroCopy) {
+    write_numbers(numbers.data(), numbers.size(), binary, zeroCopy);
+}
+
+/*
+ * Convertit un fichier texte au format binaire, pour que les mesures
+ * n'analysent plus jamais de texte.
+ */
+template <typename T>
+void convert_to_binary(const std::string& textPath, const std::string& binaryPath) {
+    auto numbers = load_numbers<T>(textPath);
+    int fd = open(binaryPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        throw std::system_error(errno, std::generic_category(), binaryPath);
+    auto header = binary_header<T>(numbers.size());
+    {
+        OutputWriter out(fd, false);
+        out.bytes(&header, sizeof(header));
+        out.bytes(numbers.data(), numbers.size() * sizeof(T));
+    }
+    close(fd);
+}
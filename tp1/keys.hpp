@@ -0,0 +1,68 @@
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#pragma once
+
+/*
+ * Types de clés triables (--type) : entiers signés ou non de toute largeur,
+ * flottants, et paires (clé, charge utile) ordonnées par la seule clé.
+ */
+
+struct KeyPair {
+    std::int64_t key;
+    std::uint64_t value;
+};
+
+inline bool operator<(const KeyPair& a, const KeyPair& b) {
+    return a.key < b.key;
+}
+
+inline bool operator==(const KeyPair& a, const KeyPair& b) {
+    return a.key == b.key && a.value == b.value;
+}
+
+/*
+ * Clé non signée dont l'ordre naturel correspond à l'ordre de T, pour les
+ * tris par base. Pour un entier signé, inverser le bit de signe place les
+ * négatifs avant les positifs.
+ */
+template <typename T>
+typename std::make_unsigned<typename std::enable_if<std::is_integral<T>::value, T>::type>::type
+radix_key(T x) {
+    using U = typename std::make_unsigned<T>::type;
+    U u = static_cast<U>(x);
+    if (std::is_signed<T>::value)
+        u ^= static_cast<U>(U(1) << (sizeof(T) * 8 - 1));
+    return u;
+}
+
+/*
+ * Flottant IEEE 754 : un positif garde l'ordre de ses bits une fois le bit
+ * de signe mis à 1 ; un négatif a tous ses bits inversés, ce qui range les
+ * plus grandes valeurs absolues en premier. -0 passe juste avant +0.
+ */
+template <typename U, typename F>
+U radix_float_key(F x) {
+    U u;
+    memcpy(&u, &x, sizeof(u));
+    const U sign = U(1) << (sizeof(U) * 8 - 1);
+    return u & sign ? ~u : u | sign;
+}
+
+inline std::uint32_t radix_key(float x) {
+    return radix_float_key<std::uint32_t>(x);
+}
+
+inline std::uint64_t radix_key(double x) {
+    return radix_float_key<std::uint64_t>(x);
+}
+
+inline std::uint64_t radix_key(const KeyPair& x) {
+    return radix_key(x.key);
+}
+
+// Type de la clé de tri par base de T (ne contient que les bits comparés).
+template <typename T>
+using RadixKey = decltype(radix_key(std::declval<T>()));
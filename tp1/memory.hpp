@@ -0,0 +1,128 @@
+#include <cmath>
+#include <cstddef>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <malloc.h>
+#include "alloc.hpp"
+
+#pragma once
+
+/*
+ * Empreinte mémoire d'un appel de tri (--memory), à la manière de
+ * PerfCounters :
+ * - allocations, octets et pic d'octets vivants passés par l'opérateur new
+ *   (voir alloc.hpp) : tampons des tris, dont celui de std::inplace_merge ;
+ * - tas retenu : croissance du tas de malloc (mallinfo2) entre le début et
+ *   la fin, mémoire gardée par l'allocateur ou non rendue ;
+ * - pic RSS : maximum de la mémoire résidente pendant l'appel, au-delà de
+ *   celle du départ. Le maximum du noyau (VmHWM) est remis à zéro au début
+ *   par /proc/self/clear_refs : il voit aussi ce qui contourne new, comme le
+ *   tampon que le qsort de la glibc obtient de malloc.
+ */
+class MemoryAccount
+{
+public:
+    enum Measure { ALLOCATIONS, BYTES, PEAK_BYTES, HEAP_BYTES, PEAK_RSS, MEASURE_COUNT };
+
+    explicit MemoryAccount(bool enable);
+
+    void start();
+    std::vector<double> stop();
+
+    static std::string header();
+    static std::string csv(const std::vector<double>& values);
+
+private:
+    static double heap_bytes();
+    static double status_bytes(const std::string& field);
+    static bool reset_peak_rss();
+
+    bool enabled;
+    bool peakReset = false;
+    double heapStart = 0;
+    double rssStart = 0;
+};
+
+MemoryAccount::MemoryAccount(bool enable)
+    : enabled(enable)
+{
+    if (enable && !reset_peak_rss())
+        std::cerr << "pic RSS indisponible (/proc/self/clear_refs)" << std::endl;
+}
+
+// Octets du tas de malloc en usage : tas principal et blocs projetés.
+double MemoryAccount::heap_bytes() {
+    auto info = mallinfo2();
+    return static_cast<double>(info.uordblks + info.hblkhd);
+}
+
+// Champ de /proc/self/status en kB (VmRSS, VmHWM), converti en octets.
+double MemoryAccount::status_bytes(const std::string& field) {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line))
+        if (line.compare(0, field.size() + 1, field + ":") == 0)
+            return std::stod(line.substr(field.size() + 1)) * 1024;
+    return NAN;
+}
+
+bool MemoryAccount::reset_peak_rss() {
+    std::ofstream clear("/proc/self/clear_refs");
+    clear << "5";
+    clear.flush();
+    return static_cast<bool>(clear);
+}
+
+void MemoryAccount::start() {
+    if (!enabled)
+        return;
+    peakReset = reset_peak_rss();
+    rssStart = status_bytes("VmRSS");
+    heapStart = heap_bytes();
+    auto& c = ALLOC_COUNTERS;
+    c.allocations = 0;
+    c.bytes = 0;
+    c.live = 0;
+    c.peak = 0;
+    ALLOC_ACCOUNTING = true;
+}
+
+// Le compte s'arrête avant toute allocation : celles de stop() n'y entrent pas.
+std::vector<double> MemoryAccount::stop() {
+    if (!enabled)
+        return std::vector<double>(MEASURE_COUNT, NAN);
+    ALLOC_ACCOUNTING = false;
+    auto& c = ALLOC_COUNTERS;
+    const double allocations = c.allocations, bytes = c.bytes, peak = c.peak;
+    const double heap = heap_bytes() - heapStart;
+
+    std::vector<double> values(MEASURE_COUNT, NAN);
+    values[ALLOCATIONS] = allocations;
+    values[BYTES] = bytes;
+    values[PEAK_BYTES] = peak;
+    values[HEAP_BYTES] = heap;
+    if (peakReset)
+        values[PEAK_RSS] = status_bytes("VmHWM") - rssStart;
+    return values;
+}
+
+std::string MemoryAccount::header() {
+    return "allocations,octets,pic_octets,tas_retenu,pic_rss";
+}
+
+// Colonnes CSV en nombres entiers ; un champ vide signale une mesure indisponible.
+std::string MemoryAccount::csv(const std::vector<double>& values) {
+    std::ostringstream out;
+    out.setf(std::ios::fixed);
+    out.precision(0);
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        if (i)
+            out << ",";
+        if (!std::isnan(values[i]))
+            out << values[i];
+    }
+    return out.str();
+}
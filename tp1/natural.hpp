@@ -0,0 +1,256 @@
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <vector>
+
+#pragma once
+
+/*
+ * Tri fusion naturel à la TimSort : on découpe l'entrée en séquences déjà
+ * croissantes (ou strictement décroissantes, qu'on retourne), on allonge
+ * les trop courtes par insertion binaire, puis on les fusionne en respectant
+ * les invariants de la pile des séquences. Les fusions passent en mode
+ * « galop » quand un côté gagne souvent : une entrée triée ou presque coûte
+ * alors O(n).
+ */
+
+const std::size_t NATURAL_MIN_GALLOP = 7;
+
+// Nombre d'éléments de [first, first+len) qui ne sont pas après key.
+template <typename It, typename T, typename Order>
+std::size_t gallop_upper(It first, std::size_t len, const T& key, Order order) {
+    std::size_t prev = 0, ofs = 1;
+    while (ofs <= len && !order(key, first[ofs - 1])) {
+        prev = ofs;
+        ofs = 2 * ofs;
+    }
+    return std::upper_bound(first + prev, first + std::min(ofs, len), key, order) - first;
+}
+
+// Nombre d'éléments de [first, first+len) strictement avant key.
+template <typename It, typename T, typename Order>
+std::size_t gallop_lower(It first, std::size_t len, const T& key, Order order) {
+    std::size_t prev = 0, ofs = 1;
+    while (ofs <= len && order(first[ofs - 1], key)) {
+        prev = ofs;
+        ofs = 2 * ofs;
+    }
+    return std::lower_bound(first + prev, first + std::min(ofs, len), key, order) - first;
+}
+
+template <typename T, typename Order>
+class NaturalMergeSort
+{
+public:
+    NaturalMergeSort(T* a, std::size_t n, Order order);
+    void sort();
+
+private:
+    struct Run {
+        std::size_t base;
+        std::size_t len;
+    };
+
+    static std::size_t minRunLength(std::size_t n);
+    std::size_t countRun(std::size_t lo);
+    void binaryInsertion(std::size_t lo, std::size_t start, std::size_t hi);
+    void mergeCollapse();
+    void mergeForceCollapse();
+    void mergeAt(std::size_t i);
+    template <typename LeftIt, typename RightIt, typename OutIt, typename Cmp>
+    void mergeRuns(LeftIt l, std::size_t nl, RightIt r, std::size_t nr, OutIt out, Cmp cmp);
+
+    T* a;
+    std::size_t n;
+    Order order;
+    std::size_t minGallop = NATURAL_MIN_GALLOP;
+    std::vector<T> tmp;
+    std::vector<Run> runs;
+};
+
+template <typename T, typename Order>
+NaturalMergeSort<T, Order>::NaturalMergeSort(T* a, std::size_t n, Order order)
+    : a(a),
+      n(n),
+      order(order)
+{}
+
+// Entre 32 et 64, choisi pour que n / minRun soit proche d'une puissance de 2.
+template <typename T, typename Order>
+std::size_t NaturalMergeSort<T, Order>::minRunLength(std::size_t n) {
+    std::size_t r = 0;
+    while (n >= 64) {
+        r |= n & 1;
+        n >>= 1;
+    }
+    return n + r;
+}
+
+template <typename T, typename Order>
+std::size_t NaturalMergeSort<T, Order>::countRun(std::size_t lo) {
+    std::size_t hi = lo + 1;
+    if (hi == n)
+        return 1;
+    if (order(a[hi], a[lo])) {
+        // Strictement décroissante, pour que le retournement reste stable.
+        while (hi + 1 < n && order(a[hi + 1], a[hi]))
+            ++hi;
+        std::reverse(a + lo, a + hi + 1);
+    } else {
+        while (hi + 1 < n && !order(a[hi + 1], a[hi]))
+            ++hi;
+    }
+    return hi + 1 - lo;
+}
+
+// [lo, start) est déjà trié ; upper_bound garde l'insertion stable.
+template <typename T, typename Order>
+void NaturalMergeSort<T, Order>::binaryInsertion(std::size_t lo, std::size_t start, std::size_t hi) {
+    for (std::size_t i = start; i < hi; ++i) {
+        T pivot = a[i];
+        T* pos = std::upper_bound(a + lo, a + i, pivot, order);
+        std::move_backward(pos, a + i, a + i + 1);
+        *pos = pivot;
+    }
+}
+
+template <typename T, typename Order>
+void NaturalMergeSort<T, Order>::sort() {
+    if (n < 2)
+        return;
+    const std::size_t minRun = minRunLength(n);
+    std::size_t lo = 0;
+    while (lo < n) {
+        std::size_t len = countRun(lo);
+        if (len < minRun) {
+            std::size_t forced = std::min(minRun, n - lo);
+            binaryInsertion(lo, lo + len, lo + forced);
+            len = forced;
+        }
+        runs.push_back({lo, len});
+        mergeCollapse();
+        lo += len;
+    }
+    mergeForceCollapse();
+}
+
+/*
+ * Invariants sur les longueurs en haut de pile (W, X, Y, Z, Z au sommet) :
+ * X > Y + Z, W > X + Y et Y > Z. Ils bornent la pile à O(log n) et
+ * équilibrent les fusions.
+ */
+template <typename T, typename Order>
+void NaturalMergeSort<T, Order>::mergeCollapse() {
+    while (runs.size() > 1) {
+        std::size_t i = runs.size() - 2;
+        if ((i > 0 && runs[i - 1].len <= runs[i].len + runs[i + 1].len) ||
+            (i > 1 && runs[i - 2].len <= runs[i - 1].len + runs[i].len)) {
+            if (runs[i - 1].len < runs[i + 1].len)
+                --i;
+            mergeAt(i);
+        } else if (runs[i].len <= runs[i + 1].len) {
+            mergeAt(i);
+        } else {
+            break;
+        }
+    }
+}
+
+template <typename T, typename Order>
+void NaturalMergeSort<T, Order>::mergeForceCollapse() {
+    while (runs.size() > 1) {
+        std::size_t i = runs.size() - 2;
+        if (i > 0 && runs[i - 1].len < runs[i + 1].len)
+            --i;
+        mergeAt(i);
+    }
+}
+
+template <typename T, typename Order>
+void NaturalMergeSort<T, Order>::mergeAt(std::size_t i) {
+    std::size_t base1 = runs[i].base, len1 = runs[i].len;
+    std::size_t base2 = runs[i + 1].base, len2 = runs[i + 1].len;
+    runs[i].len = len1 + len2;
+    runs.erase(runs.begin() + i + 1);
+
+    // Les éléments déjà à leur place aux deux bouts ne sont pas touchés.
+    std::size_t k = gallop_upper(a + base1, len1, a[base2], order);
+    base1 += k;
+    len1 -= k;
+    if (len1 == 0)
+        return;
+    len2 = gallop_lower(a + base2, len2, a[base1 + len1 - 1], order);
+    if (len2 == 0)
+        return;
+
+    // On copie la plus courte des deux dans tmp. Pour fusionner par la fin,
+    // on parcourt tout à l'envers avec l'ordre inversé.
+    if (len1 <= len2) {
+        tmp.assign(a + base1, a + base1 + len1);
+        mergeRuns(tmp.begin(), len1, a + base2, len2, a + base1, order);
+    } else {
+        tmp.assign(a + base2, a + base2 + len2);
+        auto reversed = [this](const T& x, const T& y) { return order(y, x); };
+        mergeRuns(std::make_reverse_iterator(tmp.end()), len2,
+                  std::make_reverse_iterator(a + base1 + len1), len1,
+                  std::make_reverse_iterator(a + base2 + len2), reversed);
+    }
+}
+
+/*
+ * Fusionne l (dans tmp) et r (en place) vers out, qui ne dépasse jamais r.
+ * À égalité, l passe en premier. Après NATURAL_MIN_GALLOP victoires
+ * consécutives d'un côté, on cherche d'un coup, par recherche exponentielle,
+ * combien d'éléments recopier ; minGallop s'adapte à l'utilité du galop.
+ */
+template <typename T, typename Order>
+template <typename LeftIt, typename RightIt, typename OutIt, typename Cmp>
+void NaturalMergeSort<T, Order>::mergeRuns(LeftIt l, std::size_t nl, RightIt r, std::size_t nr,
+                                           OutIt out, Cmp cmp) {
+    std::size_t i = 0, j = 0;
+    while (i < nl && j < nr) {
+        std::size_t winsL = 0, winsR = 0;
+        while (i < nl && j < nr && winsL < minGallop && winsR < minGallop) {
+            if (cmp(r[j], l[i])) {
+                *out++ = r[j++];
+                ++winsR;
+                winsL = 0;
+            } else {
+                *out++ = l[i++];
+                ++winsL;
+                winsR = 0;
+            }
+        }
+
+        while (i < nl && j < nr) {
+            std::size_t k = gallop_upper(l + i, nl - i, r[j], cmp);
+            out = std::copy(l + i, l + i + k, out);
+            i += k;
+            if (i == nl)
+                break;
+            *out++ = r[j++];
+            if (j == nr)
+                break;
+            std::size_t m = gallop_lower(r + j, nr - j, l[i], cmp);
+            out = std::copy(r + j, r + j + m, out);
+            j += m;
+            if (j == nr)
+                break;
+            *out++ = l[i++];
+            if (k < NATURAL_MIN_GALLOP && m < NATURAL_MIN_GALLOP) {
+                ++minGallop;
+                break;
+            }
+            if (minGallop > 1)
+                --minGallop;
+        }
+    }
+    // Le reste de r est déjà en place.
+    std::copy(l + i, l + nl, out);
+}
+
+template <typename T>
+void natural_mergesort(T* a, std::size_t n) {
+    NaturalMergeSort<T, std::less<T>>(a, n, std::less<T>()).sort();
+}
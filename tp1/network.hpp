@@ -0,0 +1,295 @@
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <vector>
+#if defined(__AVX2__) || defined(__SSE4_2__)
+#include <immintrin.h>
+#endif
+
+#pragma once
+
+/*
+ * Réseaux de tri et fusion vectorisés pour des clés signées de 64 bits.
+ * AVX2 traite 4 clés par registre, SSE4.2 en traite 2 ; sans l'un ni
+ * l'autre (compiler avec -march=native), on retombe sur du code scalaire.
+ * AVX2 n'a pas de min/max sur 64 bits : on compare puis on mélange (blendv).
+ */
+
+// Blocs de taille inférieure ou égale à ce seuil sont triés par réseaux puis
+// fusionnés au sein du bloc ; au-dessus, on coupe en deux récursivement.
+std::size_t NETWORK_SEUIL = 64;
+
+#if defined(__AVX2__)
+
+const std::size_t NETWORK_BLOCK = 16;
+
+inline void cmpswap(__m256i& a, __m256i& b) {
+    __m256i gt = _mm256_cmpgt_epi64(a, b);
+    __m256i lo = _mm256_blendv_epi8(a, b, gt);
+    b = _mm256_blendv_epi8(b, a, gt);
+    a = lo;
+}
+
+inline __m256i reverse(__m256i v) {
+    return _mm256_permute4x64_epi64(v, 0x1B);
+}
+
+// Trie un registre bitonique : comparaisons à distance 2 puis 1.
+inline __m256i cleanup(__m256i v) {
+    __m256i s = _mm256_permute4x64_epi64(v, 0x4E);
+    __m256i gt = _mm256_cmpgt_epi64(v, s);
+    __m256i lo = _mm256_blendv_epi8(v, s, gt);
+    __m256i hi = _mm256_blendv_epi8(s, v, gt);
+    v = _mm256_blend_epi32(lo, hi, 0xF0);
+    s = _mm256_permute4x64_epi64(v, 0xB1);
+    gt = _mm256_cmpgt_epi64(v, s);
+    lo = _mm256_blendv_epi8(v, s, gt);
+    hi = _mm256_blendv_epi8(s, v, gt);
+    return _mm256_blend_epi32(lo, hi, 0xCC);
+}
+
+// Fusion bitonique de deux registres triés : a reçoit les 4 plus petits.
+inline void merge4(__m256i& a, __m256i& b) {
+    b = reverse(b);
+    cmpswap(a, b);
+    a = cleanup(a);
+    b = cleanup(b);
+}
+
+// Fusion bitonique de deux suites triées de 8 (a0 a1) et (b0 b1).
+inline void merge8(__m256i& a0, __m256i& a1, __m256i& b0, __m256i& b1) {
+    __m256i r0 = reverse(b1);
+    __m256i r1 = reverse(b0);
+    cmpswap(a0, r0);
+    cmpswap(a1, r1);
+    cmpswap(a0, a1);
+    cmpswap(r0, r1);
+    a0 = cleanup(a0);
+    a1 = cleanup(a1);
+    b0 = cleanup(r0);
+    b1 = cleanup(r1);
+}
+
+// Trie 16 clés : réseau sur les colonnes, transposition, puis fusions.
+inline void network_sort_block(long long* p) {
+    auto q = reinterpret_cast<__m256i*>(p);
+    __m256i r0 = _mm256_loadu_si256(q);
+    __m256i r1 = _mm256_loadu_si256(q + 1);
+    __m256i r2 = _mm256_loadu_si256(q + 2);
+    __m256i r3 = _mm256_loadu_si256(q + 3);
+
+    cmpswap(r0, r1);
+    cmpswap(r2, r3);
+    cmpswap(r0, r2);
+    cmpswap(r1, r3);
+    cmpswap(r1, r2);
+
+    __m256i t0 = _mm256_unpacklo_epi64(r0, r1);
+    __m256i t1 = _mm256_unpackhi_epi64(r0, r1);
+    __m256i t2 = _mm256_unpacklo_epi64(r2, r3);
+    __m256i t3 = _mm256_unpackhi_epi64(r2, r3);
+    r0 = _mm256_permute2x128_si256(t0, t2, 0x20);
+    r1 = _mm256_permute2x128_si256(t1, t3, 0x20);
+    r2 = _mm256_permute2x128_si256(t0, t2, 0x31);
+    r3 = _mm256_permute2x128_si256(t1, t3, 0x31);
+
+    merge4(r0, r1);
+    merge4(r2, r3);
+    merge8(r0, r1, r2, r3);
+
+    _mm256_storeu_si256(q, r0);
+    _mm256_storeu_si256(q + 1, r1);
+    _mm256_storeu_si256(q + 2, r2);
+    _mm256_storeu_si256(q + 3, r3);
+}
+
+const std::size_t MERGE_LANES = 4;
+
+inline __m256i merge_load(const long long* p) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+
+inline void merge_store(long long* p, __m256i v) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v);
+}
+
+using MergeVec = __m256i;
+
+#elif defined(__SSE4_2__)
+
+const std::size_t NETWORK_BLOCK = 4;
+
+inline void cmpswap(__m128i& a, __m128i& b) {
+    __m128i gt = _mm_cmpgt_epi64(a, b);
+    __m128i lo = _mm_blendv_epi8(a, b, gt);
+    b = _mm_blendv_epi8(b, a, gt);
+    a = lo;
+}
+
+inline __m128i reverse(__m128i v) {
+    return _mm_shuffle_epi32(v, 0x4E);
+}
+
+inline __m128i cleanup(__m128i v) {
+    __m128i s = reverse(v);
+    __m128i gt = _mm_cmpgt_epi64(v, s);
+    __m128i lo = _mm_blendv_epi8(v, s, gt);
+    __m128i hi = _mm_blendv_epi8(s, v, gt);
+    return _mm_blend_epi16(lo, hi, 0xF0);
+}
+
+inline void merge4(__m128i& a, __m128i& b) {
+    b = reverse(b);
+    cmpswap(a, b);
+    a = cleanup(a);
+    b = cleanup(b);
+}
+
+// Trie 4 clés : réseau sur les colonnes, transposition, fusion.
+inline void network_sort_block(long long* p) {
+    auto q = reinterpret_cast<__m128i*>(p);
+    __m128i r0 = _mm_loadu_si128(q);
+    __m128i r1 = _mm_loadu_si128(q + 1);
+    cmpswap(r0, r1);
+    __m128i t0 = _mm_unpacklo_epi64(r0, r1);
+    __m128i t1 = _mm_unpackhi_epi64(r0, r1);
+    merge4(t0, t1);
+    _mm_storeu_si128(q, t0);
+    _mm_storeu_si128(q + 1, t1);
+}
+
+const std::size_t MERGE_LANES = 2;
+
+inline __m128i merge_load(const long long* p) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+}
+
+inline void merge_store(long long* p, __m128i v) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v);
+}
+
+using MergeVec = __m128i;
+
+#else
+
+const std::size_t NETWORK_BLOCK = 4;
+
+// Réseau optimal à 5 comparateurs ; min/max donnent des cmov sans branchement.
+inline void network_sort_block(long long* p) {
+    auto cs = [p](int i, int j) {
+        long long a = p[i], b = p[j];
+        p[i] = std::min(a, b);
+        p[j] = std::max(a, b);
+    };
+    cs(0, 1); cs(2, 3); cs(0, 2); cs(1, 3); cs(1, 2);
+}
+
+#endif
+
+/*
+ * Fusionne a et b dans out. La version vectorielle garde en registre les
+ * MERGE_LANES plus grandes clés vues et les refusionne avec le prochain
+ * registre chargé du côté dont la tête est la plus petite.
+ */
+inline void network_merge(const long long* a, std::size_t na,
+                          const long long* b, std::size_t nb, long long* out) {
+#if defined(__AVX2__) || defined(__SSE4_2__)
+    if (na < MERGE_LANES || nb < MERGE_LANES) {
+        std::merge(a, a + na, b, b + nb, out);
+        return;
+    }
+    const long long* ea = a + na;
+    const long long* eb = b + nb;
+    MergeVec lo = merge_load(a);
+    MergeVec hi = merge_load(b);
+    a += MERGE_LANES;
+    b += MERGE_LANES;
+    merge4(lo, hi);
+    merge_store(out, lo);
+    out += MERGE_LANES;
+    while (ea - a >= static_cast<std::ptrdiff_t>(MERGE_LANES) &&
+           eb - b >= static_cast<std::ptrdiff_t>(MERGE_LANES)) {
+        if (*a < *b) {
+            lo = merge_load(a);
+            a += MERGE_LANES;
+        } else {
+            lo = merge_load(b);
+            b += MERGE_LANES;
+        }
+        merge4(lo, hi);
+        merge_store(out, lo);
+        out += MERGE_LANES;
+    }
+
+    // Fin scalaire à trois voies : le registre haut et les deux restes.
+    long long h[MERGE_LANES];
+    merge_store(h, hi);
+    const long long* c = h;
+    const long long* ec = h + MERGE_LANES;
+    while (c < ec) {
+        if (a < ea && *a < *c && (b == eb || *a <= *b))
+            *out++ = *a++;
+        else if (b < eb && *b < *c)
+            *out++ = *b++;
+        else
+            *out++ = *c++;
+    }
+    out = std::merge(a, ea, b, eb, out);
+#else
+    std::merge(a, a + na, b, b + nb, out);
+#endif
+}
+
+/*
+ * Feuille : blocs triés par réseau (le dernier est complété par le maximum),
+ * puis fusions ascendantes en alternant entre a et buf.
+ */
+inline void network_leaf(long long* a, long long* buf, std::size_t n, bool toBuf) {
+    for (std::size_t i = 0; i < n; i += NETWORK_BLOCK) {
+        if (n - i >= NETWORK_BLOCK) {
+            network_sort_block(a + i);
+        } else {
+            long long tmp[NETWORK_BLOCK];
+            std::fill(tmp, tmp + NETWORK_BLOCK, std::numeric_limits<long long>::max());
+            std::copy(a + i, a + n, tmp);
+            network_sort_block(tmp);
+            std::copy(tmp, tmp + (n - i), a + i);
+        }
+    }
+
+    long long* src = a;
+    long long* dst = buf;
+    for (std::size_t w = NETWORK_BLOCK; w < n; w *= 2) {
+        for (std::size_t lo = 0; lo < n; lo += 2 * w) {
+            std::size_t mid = std::min(lo + w, n);
+            std::size_t hi = std::min(lo + 2 * w, n);
+            network_merge(src + lo, mid - lo, src + mid, hi - mid, dst + lo);
+        }
+        std::swap(src, dst);
+    }
+    long long* want = toBuf ? buf : a;
+    if (src != want)
+        std::copy(src, src + n, want);
+}
+
+/*
+ * Tri fusion hybride : chaque feuille récursive d'au plus NETWORK_SEUIL clés
+ * passe par les réseaux de tri, et toutes les fusions sont vectorisées.
+ */
+inline void network_mergesort(long long* a, long long* buf, std::size_t n, bool toBuf) {
+    if (n <= NETWORK_SEUIL) {
+        network_leaf(a, buf, n, toBuf);
+        return;
+    }
+    std::size_t half = n / 2;
+    network_mergesort(a, buf, half, !toBuf);
+    network_mergesort(a + half, buf + half, n - half, !toBuf);
+    long long* src = toBuf ? a : buf;
+    long long* dst = toBuf ? buf : a;
+    network_merge(src, half, src + half, n - half, dst);
+}
+
+inline void network_mergesort(long long* a, std::size_t n) {
+    std::vector<long long> buf(n);
+    network_mergesort(a, buf.data(), n, false);
+}
@@ -0,0 +1,372 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#pragma once
+
+/*
+ * Pattern-defeating quicksort (Orson Peters, https://github.com/orlp/pdqsort).
+ * - pivot médiane de 3, ou pseudo-médiane de 9 (ninther) au-delà de 128 ;
+ * - partition sans branchement à la BlockQuicksort : les comparaisons
+ *   remplissent deux tampons de positions à échanger, sans saut conditionnel ;
+ * - une partition déjà faite est détectée et finie par insertion partielle ;
+ * - beaucoup de doublons du pivot : partition « à gauche » qui les regroupe ;
+ * - après log2(n) partitions déséquilibrées, on casse les motifs en échangeant
+ *   quelques éléments, puis on bascule sur le tri par tas : O(n log n) garanti.
+ */
+
+const std::ptrdiff_t PDQ_INSERTION_SORT = 24;
+const std::ptrdiff_t PDQ_NINTHER = 128;
+const std::ptrdiff_t PDQ_PARTIAL_INSERTION_LIMIT = 8;
+const std::ptrdiff_t PDQ_BLOCK = 64;
+const std::size_t PDQ_CACHELINE = 64;
+
+template <typename It, typename Compare>
+void pdq_insertion_sort(It begin, It end, Compare comp) {
+    using T = typename std::iterator_traits<It>::value_type;
+    if (begin == end)
+        return;
+    for (It cur = begin + 1; cur != end; ++cur) {
+        It sift = cur;
+        It sift_1 = cur - 1;
+        if (comp(*sift, *sift_1)) {
+            T tmp = std::move(*sift);
+            do {
+                *sift-- = std::move(*sift_1);
+            } while (sift != begin && comp(tmp, *--sift_1));
+            *sift = std::move(tmp);
+        }
+    }
+}
+
+// Comme ci-dessus, mais *(begin - 1) sert de sentinelle : pas de test de borne.
+template <typename It, typename Compare>
+void pdq_unguarded_insertion_sort(It begin, It end, Compare comp) {
+    using T = typename std::iterator_traits<It>::value_type;
+    if (begin == end)
+        return;
+    for (It cur = begin + 1; cur != end; ++cur) {
+        It sift = cur;
+        It sift_1 = cur - 1;
+        if (comp(*sift, *sift_1)) {
+            T tmp = std::move(*sift);
+            do {
+                *sift-- = std::move(*sift_1);
+            } while (comp(tmp, *--sift_1));
+            *sift = std::move(tmp);
+        }
+    }
+}
+
+// Abandonne (false) dès que plus de PDQ_PARTIAL_INSERTION_LIMIT éléments ont bougé.
+template <typename It, typename Compare>
+bool pdq_partial_insertion_sort(It begin, It end, Compare comp) {
+    using T = typename std::iterator_traits<It>::value_type;
+    if (begin == end)
+        return true;
+    std::ptrdiff_t limit = 0;
+    for (It cur = begin + 1; cur != end; ++cur) {
+        It sift = cur;
+        It sift_1 = cur - 1;
+        if (comp(*sift, *sift_1)) {
+            T tmp = std::move(*sift);
+            do {
+                *sift-- = std::move(*sift_1);
+            } while (sift != begin && comp(tmp, *--sift_1));
+            *sift = std::move(tmp);
+            limit += cur - sift;
+        }
+        if (limit > PDQ_PARTIAL_INSERTION_LIMIT)
+            return false;
+    }
+    return true;
+}
+
+template <typename It, typename Compare>
+void pdq_sort2(It a, It b, Compare comp) {
+    if (comp(*b, *a))
+        std::iter_swap(a, b);
+}
+
+template <typename It, typename Compare>
+void pdq_sort3(It a, It b, It c, Compare comp) {
+    pdq_sort2(a, b, comp);
+    pdq_sort2(b, c, comp);
+    pdq_sort2(a, b, comp);
+}
+
+template <typename T>
+T* pdq_align_cacheline(T* p) {
+    std::uintptr_t ip = reinterpret_cast<std::uintptr_t>(p);
+    ip = (ip + PDQ_CACHELINE - 1) & -PDQ_CACHELINE;
+    return reinterpret_cast<T*>(ip);
+}
+
+template <typename It>
+void pdq_swap_offsets(It first, It last, unsigned char* offsets_l, unsigned char* offsets_r,
+                      std::size_t num, bool use_swaps) {
+    using T = typename std::iterator_traits<It>::value_type;
+    if (use_swaps) {
+        // Nombres égaux de chaque côté : échanges simples (nécessaire pour
+        // que le pivot ne soit pas écrasé quand aucun élément n'est mal placé).
+        for (std::size_t i = 0; i < num; ++i)
+            std::iter_swap(first + offsets_l[i], last - offsets_r[i]);
+    } else if (num > 0) {
+        It l = first + offsets_l[0];
+        It r = last - offsets_r[0];
+        T tmp(std::move(*l));
+        *l = std::move(*r);
+        for (std::size_t i = 1; i < num; ++i) {
+            l = first + offsets_l[i];
+            *r = std::move(*l);
+            r = last - offsets_r[i];
+            *l = std::move(*r);
+        }
+        *r = std::move(tmp);
+    }
+}
+
+/*
+ * Partition autour de *begin : [begin, pivot) < pivot <= (pivot, end).
+ * Renvoie la position du pivot et si la partition était déjà faite.
+ * Chaque bloc de PDQ_BLOCK éléments est parcouru sans branchement : le
+ * résultat de la comparaison fait avancer (ou non) l'indice d'écriture.
+ */
+template <typename It, typename Compare>
+std::pair<It, bool> pdq_partition_right_branchless(It begin, It end, Compare comp) {
+    using T = typename std::iterator_traits<It>::value_type;
+    T pivot(std::move(*begin));
+    It first = begin;
+    It last = end;
+
+    while (comp(*++first, pivot))
+        ;
+    if (first - 1 == begin)
+        while (first < last && !comp(*--last, pivot))
+            ;
+    else
+        while (!comp(*--last, pivot))
+            ;
+
+    bool already_partitioned = first >= last;
+    if (!already_partitioned) {
+        std::iter_swap(first, last);
+        ++first;
+
+        unsigned char offsets_l_storage[PDQ_BLOCK + PDQ_CACHELINE];
+        unsigned char offsets_r_storage[PDQ_BLOCK + PDQ_CACHELINE];
+        unsigned char* offsets_l = pdq_align_cacheline(offsets_l_storage);
+        unsigned char* offsets_r = pdq_align_cacheline(offsets_r_storage);
+
+        It offsets_l_base = first;
+        It offsets_r_base = last;
+        std::size_t num_l = 0, num_r = 0, start_l = 0, start_r = 0;
+
+        while (first < last) {
+            std::size_t num_unknown = last - first;
+            std::size_t left_split = num_l == 0 ? (num_r == 0 ? num_unknown / 2 : num_unknown) : 0;
+            std::size_t right_split = num_r == 0 ? (num_unknown - left_split) : 0;
+
+            if (left_split >= static_cast<std::size_t>(PDQ_BLOCK)) {
+                for (std::size_t i = 0; i < static_cast<std::size_t>(PDQ_BLOCK); ++i) {
+                    offsets_l[num_l] = i;
+                    num_l += !comp(*first, pivot);
+                    ++first;
+                }
+            } else {
+                for (std::size_t i = 0; i < left_split; ++i) {
+                    offsets_l[num_l] = i;
+                    num_l += !comp(*first, pivot);
+                    ++first;
+                }
+            }
+
+            if (right_split >= static_cast<std::size_t>(PDQ_BLOCK)) {
+                for (std::size_t i = 0; i < static_cast<std::size_t>(PDQ_BLOCK);) {
+                    offsets_r[num_r] = ++i;
+                    num_r += comp(*--last, pivot);
+                }
+            } else {
+                for (std::size_t i = 0; i < right_split;) {
+                    offsets_r[num_r] = ++i;
+                    num_r += comp(*--last, pivot);
+                }
+            }
+
+            std::size_t num = std::min(num_l, num_r);
+            pdq_swap_offsets(offsets_l_base, offsets_r_base, offsets_l + start_l,
+                             offsets_r + start_r, num, num_l == num_r);
+            num_l -= num;
+            num_r -= num;
+            start_l += num;
+            start_r += num;
+
+            if (num_l == 0) {
+                start_l = 0;
+                offsets_l_base = first;
+            }
+            if (num_r == 0) {
+                start_r = 0;
+                offsets_r_base = last;
+            }
+        }
+
+        // Il reste au plus un tampon non vide : on vide ses éléments vers le milieu.
+        if (num_l) {
+            offsets_l += start_l;
+            while (num_l--)
+                std::iter_swap(offsets_l_base + offsets_l[num_l], --last);
+            first = last;
+        }
+        if (num_r) {
+            offsets_r += start_r;
+            while (num_r--)
+                std::iter_swap(offsets_r_base - offsets_r[num_r], first), ++first;
+            last = first;
+        }
+    }
+
+    It pivot_pos = first - 1;
+    *begin = std::move(*pivot_pos);
+    *pivot_pos = std::move(pivot);
+    return std::make_pair(pivot_pos, already_partitioned);
+}
+
+/*
+ * Partition avec les égaux à gauche : [begin, pivot] <= pivot < (pivot, end).
+ * Utilisée quand le pivot égale l'élément qui précède la tranche : tous les
+ * égaux sont alors regroupés et ne seront plus jamais retriés.
+ */
+template <typename It, typename Compare>
+It pdq_partition_left(It begin, It end, Compare comp) {
+    using T = typename std::iterator_traits<It>::value_type;
+    T pivot(std::move(*begin));
+    It first = begin;
+    It last = end;
+
+    while (comp(pivot, *--last))
+        ;
+    if (last + 1 == end)
+        while (first < last && !comp(pivot, *++first))
+            ;
+    else
+        while (!comp(pivot, *++first))
+            ;
+
+    while (first < last) {
+        std::iter_swap(first, last);
+        while (comp(pivot, *--last))
+            ;
+        while (!comp(pivot, *++first))
+            ;
+    }
+
+    It pivot_pos = last;
+    *begin = std::move(*pivot_pos);
+    *pivot_pos = std::move(pivot);
+    return pivot_pos;
+}
+
+template <typename It, typename Compare>
+void pdq_loop(It begin, It end, Compare comp, int bad_allowed, bool leftmost = true) {
+    using Diff = typename std::iterator_traits<It>::difference_type;
+
+    while (true) {
+        Diff size = end - begin;
+
+        if (size < PDQ_INSERTION_SORT) {
+            if (leftmost)
+                pdq_insertion_sort(begin, end, comp);
+            else
+                pdq_unguarded_insertion_sort(begin, end, comp);
+            return;
+        }
+
+        Diff s2 = size / 2;
+        if (size > PDQ_NINTHER) {
+            pdq_sort3(begin, begin + s2, end - 1, comp);
+            pdq_sort3(begin + 1, begin + (s2 - 1), end - 2, comp);
+            pdq_sort3(begin + 2, begin + (s2 + 1), end - 3, comp);
+            pdq_sort3(begin + (s2 - 1), begin + s2, begin + (s2 + 1), comp);
+            std::iter_swap(begin, begin + s2);
+        } else {
+            pdq_sort3(begin + s2, begin, end - 1, comp);
+        }
+
+        // Pivot égal au prédécesseur : aucun élément de la tranche n'est plus
+        // petit, on regroupe les égaux et on ne trie que la droite.
+        if (!leftmost && !comp(*(begin - 1), *begin)) {
+            begin = pdq_partition_left(begin, end, comp) + 1;
+            continue;
+        }
+
+        auto part = pdq_partition_right_branchless(begin, end, comp);
+        It pivot_pos = part.first;
+        bool already_partitioned = part.second;
+
+        Diff l_size = pivot_pos - begin;
+        Diff r_size = end - (pivot_pos + 1);
+        bool highly_unbalanced = l_size < size / 8 || r_size < size / 8;
+
+        if (highly_unbalanced) {
+            if (--bad_allowed == 0) {
+                std::make_heap(begin, end, comp);
+                std::sort_heap(begin, end, comp);
+                return;
+            }
+
+            // Casse les motifs adverses en déplaçant quelques éléments.
+            if (l_size >= PDQ_INSERTION_SORT) {
+                std::iter_swap(begin, begin + l_size / 4);
+                std::iter_swap(pivot_pos - 1, pivot_pos - l_size / 4);
+                if (l_size > PDQ_NINTHER) {
+                    std::iter_swap(begin + 1, begin + (l_size / 4 + 1));
+                    std::iter_swap(begin + 2, begin + (l_size / 4 + 2));
+                    std::iter_swap(pivot_pos - 2, pivot_pos - (l_size / 4 + 1));
+                    std::iter_swap(pivot_pos - 3, pivot_pos - (l_size / 4 + 2));
+                }
+            }
+            if (r_size >= PDQ_INSERTION_SORT) {
+                std::iter_swap(pivot_pos + 1, pivot_pos + (1 + r_size / 4));
+                std::iter_swap(end - 1, end - r_size / 4);
+                if (r_size > PDQ_NINTHER) {
+                    std::iter_swap(pivot_pos + 2, pivot_pos + (2 + r_size / 4));
+                    std::iter_swap(pivot_pos + 3, pivot_pos + (3 + r_size / 4));
+                    std::iter_swap(end - 2, end - (1 + r_size / 4));
+                    std::iter_swap(end - 3, end - (2 + r_size / 4));
+                }
+            }
+        } else {
+            // Partition déjà faite et bien équilibrée : l'entrée est peut-être
+            // déjà triée, on tente une insertion bornée des deux côtés.
+            if (already_partitioned &&
+                pdq_partial_insertion_sort(begin, pivot_pos, comp) &&
+                pdq_partial_insertion_sort(pivot_pos + 1, end, comp))
+                return;
+        }
+
+        // Récursion sur la gauche, boucle sur la droite.
+        pdq_loop(begin, pivot_pos, comp, bad_allowed, leftmost);
+        begin = pivot_pos + 1;
+        leftmost = false;
+    }
+}
+
+template <typename It, typename Compare>
+void pdqsort(It begin, It end, Compare comp) {
+    if (begin == end)
+        return;
+    int log2 = 0;
+    for (auto n = end - begin; n > 1; n >>= 1)
+        ++log2;
+    pdq_loop(begin, end, comp, log2);
+}
+
+template <typename T>
+void pdqsort(std::vector<T>& v) {
+    pdqsort(v.begin(), v.end(), std::less<T>());
+}
@@ -0,0 +1,97 @@
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <vector>
+#include "pool.hpp"
+
+#pragma once
+
+// Tri fusion séquentiel (sort.cpp).
+template <typename RandomAccessIterator, typename Order>
+void mergesort(RandomAccessIterator first, RandomAccessIterator last, Order order);
+
+// Sous ce seuil, on utilise le tri fusion séquentiel.
+std::size_t PMERGE_CUTOFF = 8192;
+// Sous ce seuil, une fusion n'est pas découpée entre plusieurs tâches.
+std::size_t PMERGE_MERGE_GRAIN = 16384;
+
+/*
+ * Co-rang : nombre d'éléments de a parmi les k premiers de la fusion stable
+ * de a et b (à égalité, les éléments de a passent en premier).
+ */
+template <typename T, typename Order>
+std::size_t co_rank(std::size_t k, const T* a, std::size_t na,
+                    const T* b, std::size_t nb, Order order) {
+    std::size_t lo = k > nb ? k - nb : 0;
+    std::size_t hi = std::min(k, na);
+    while (lo < hi) {
+        std::size_t i = lo + (hi - lo) / 2;
+        std::size_t j = k - i;
+        if (j > 0 && !order(b[j - 1], a[i]))
+            lo = i + 1;
+        else
+            hi = i;
+    }
+    return lo;
+}
+
+/*
+ * Fusionne a et b dans out. La sortie est découpée en segments de taille
+ * égale ; les bornes de chaque segment dans a et b sont trouvées par co-rang,
+ * ce qui rend les segments indépendants.
+ */
+template <typename T, typename Order>
+void parallel_merge(const T* a, std::size_t na, const T* b, std::size_t nb,
+                    T* out, Order order) {
+    std::size_t n = na + nb;
+    std::size_t parts = std::min<std::size_t>(ThreadPool::global().size(),
+                                              n / PMERGE_MERGE_GRAIN);
+    if (parts < 2) {
+        std::merge(a, a + na, b, b + nb, out, order);
+        return;
+    }
+
+    TaskGroup group;
+    for (std::size_t p = 0; p < parts; ++p) {
+        group.run([=] {
+            std::size_t k0 = n * p / parts;
+            std::size_t k1 = n * (p + 1) / parts;
+            std::size_t i0 = co_rank(k0, a, na, b, nb, order);
+            std::size_t i1 = co_rank(k1, a, na, b, nb, order);
+            std::merge(a + i0, a + i1, b + (k0 - i0), b + (k1 - i1), out + k0, order);
+        });
+    }
+    group.wait();
+}
+
+/*
+ * Trie [a, a+n). Le résultat est laissé dans buf si toBuf, sinon dans a.
+ * Les niveaux alternent entre les deux tableaux, ce qui évite toute copie
+ * hors des feuilles.
+ */
+template <typename T, typename Order>
+void pmergesort(T* a, T* buf, std::size_t n, bool toBuf, Order order) {
+    if (n <= PMERGE_CUTOFF) {
+        mergesort(a, a + n, order);
+        if (toBuf)
+            std::copy(a, a + n, buf);
+        return;
+    }
+
+    std::size_t half = n / 2;
+    TaskGroup group;
+    group.run([=] { pmergesort(a, buf, half, !toBuf, order); });
+    pmergesort(a + half, buf + half, n - half, !toBuf, order);
+    group.wait();
+
+    T* src = toBuf ? a : buf;
+    T* dst = toBuf ? buf : a;
+    parallel_merge(src, half, src + half, n - half, dst, order);
+}
+
+template <typename T>
+void pmergesort(T* a, std::size_t n) {
+    std::vector<T> buf(n);
+    pmergesort(a, buf.data(), n, false, std::less<T>());
+}
@@ -0,0 +1,202 @@
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#pragma once
+
+/*
+ * Bassin de fils d'exécution à vol de tâches (work stealing).
+ * Chaque participant possède sa propre file : il empile et dépile à l'arrière
+ * (LIFO, bonne localité), les autres volent à l'avant (les plus grosses tâches).
+ * La file 0 appartient aux fils qui ne font pas partie du bassin (ex. main).
+ */
+class ThreadPool
+{
+public:
+    using Task = std::function<void()>;
+
+    explicit ThreadPool(unsigned int nThreads);
+    ~ThreadPool();
+
+    unsigned int size() const noexcept;
+    void spawn(Task task);
+    bool tryRunOne();
+
+    static void setThreadCount(unsigned int n);
+    static void restart();
+    static ThreadPool& global();
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void workerLoop(unsigned int index);
+    bool pop(unsigned int index, Task& task);
+    bool steal(unsigned int thief, Task& task);
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<bool> done{false};
+    std::atomic<int> pending{0};
+    std::mutex idleMutex;
+    std::condition_variable idle;
+
+    static thread_local unsigned int localIndex;
+    static unsigned int requestedThreads;
+    static std::unique_ptr<ThreadPool> instance;
+};
+
+thread_local unsigned int ThreadPool::localIndex = 0;
+unsigned int ThreadPool::requestedThreads = 0;
+std::unique_ptr<ThreadPool> ThreadPool::instance;
+
+ThreadPool::ThreadPool(unsigned int nThreads) {
+    if (nThreads == 0)
+        nThreads = 1;
+    for (unsigned int i = 0; i < nThreads; ++i)
+        queues.emplace_back(new Queue);
+    // Le fil appelant compte comme un participant : il aide pendant qu'il attend.
+    for (unsigned int i = 1; i < nThreads; ++i)
+        workers.emplace_back(&ThreadPool::workerLoop, this, i);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(idleMutex);
+        done = true;
+    }
+    idle.notify_all();
+    for (auto& w : workers)
+        w.join();
+}
+
+unsigned int ThreadPool::size() const noexcept {
+    return queues.size();
+}
+
+void ThreadPool::spawn(Task task) {
+    auto& q = *queues[localIndex];
+    {
+        std::lock_guard<std::mutex> lock(q.mutex);
+        q.tasks.push_back(std::move(task));
+    }
+    pending++;
+    if (!workers.empty()) {
+        std::lock_guard<std::mutex> lock(idleMutex);
+        idle.notify_one();
+    }
+}
+
+bool ThreadPool::tryRunOne() {
+    Task task;
+    if (pop(localIndex, task) || steal(localIndex, task)) {
+        pending--;
+        task();
+        return true;
+    }
+    return false;
+}
+
+bool ThreadPool::pop(unsigned int index, Task& task) {
+    auto& q = *queues[index];
+    std::lock_guard<std::mutex> lock(q.mutex);
+    if (q.tasks.empty())
+        return false;
+    task = std::move(q.tasks.back());
+    q.tasks.pop_back();
+    return true;
+}
+
+bool ThreadPool::steal(unsigned int thief, Task& task) {
+    for (unsigned int k = 1; k < queues.size(); ++k) {
+        auto& q = *queues[(thief + k) % queues.size()];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (!q.tasks.empty()) {
+            task = std::move(q.tasks.front());
+            q.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::workerLoop(unsigned int index) {
+    localIndex = index;
+    while (!done) {
+        if (tryRunOne())
+            continue;
+        std::unique_lock<std::mutex> lock(idleMutex);
+        idle.wait(lock, [this] { return done || pending > 0; });
+    }
+}
+
+// Le bassin global est recréé à la prochaine utilisation (aucune tâche ne
+// doit être en cours).
+void ThreadPool::setThreadCount(unsigned int n) {
+    requestedThreads = n;
+    instance.reset();
+}
+
+// Recrée le bassin global avec autant de fils : les nouveaux fils héritent
+// des compteurs matériels ouverts entre-temps (voir counters.hpp).
+void ThreadPool::restart() {
+    setThreadCount(global().size());
+    global();
+}
+
+ThreadPool& ThreadPool::global() {
+    if (!instance)
+        instance.reset(new ThreadPool(requestedThreads ? requestedThreads
+                                                       : std::thread::hardware_concurrency()));
+    return *instance;
+}
+
+/*
+ * Groupe de tâches fork-join : wait() exécute des tâches (locales ou volées)
+ * jusqu'à ce que toutes celles du groupe soient terminées.
+ */
+class TaskGroup
+{
+public:
+    explicit TaskGroup(ThreadPool& pool = ThreadPool::global());
+    ~TaskGroup();
+
+    template <typename F>
+    void run(F f);
+    void wait();
+
+private:
+    ThreadPool& pool;
+    std::atomic<int> remaining{0};
+};
+
+TaskGroup::TaskGroup(ThreadPool& pool)
+    : pool(pool)
+{}
+
+TaskGroup::~TaskGroup() {
+    wait();
+}
+
+template <typename F>
+void TaskGroup::run(F f) {
+    remaining++;
+    pool.spawn([this, f] {
+        f();
+        remaining--;
+    });
+}
+
+void TaskGroup::wait() {
+    while (remaining > 0) {
+        if (!pool.tryRunOne())
+            std::this_thread::yield();
+    }
+}
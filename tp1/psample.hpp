@@ -0,0 +1,153 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "pdq.hpp"
+#include "pool.hpp"
+
+#pragma once
+
+// Sous ce seuil, le tri par échantillonnage ne vaut pas sa mise en place.
+std::size_t PSAMPLE_CUTOFF = std::size_t(1) << 16;
+// Nombre maximal de paquets (puissance de 2, tient dans un octet d'oracle).
+const std::size_t PSAMPLE_MAX_BUCKETS = 256;
+// Taille visée d'un paquet, pour qu'il tienne en cache L2.
+std::size_t PSAMPLE_BUCKET_TARGET = 4096;
+// Éléments échantillonnés par séparateur.
+const std::size_t PSAMPLE_OVERSAMPLING = 16;
+
+/*
+ * Classifieur en arbre de recherche implicite : les k-1 séparateurs sont
+ * rangés en largeur d'abord (tree[1] la racine, enfants 2i et 2i+1).
+ * Descendre l'arbre ne fait qu'additionner le résultat des comparaisons,
+ * sans branchement, et log2(k) étapes donnent le paquet.
+ */
+template <typename T>
+class SplitterTree
+{
+public:
+    SplitterTree(const std::vector<T>& sortedSplitters, unsigned int logBuckets);
+
+    std::size_t classify(T x) const noexcept;
+
+private:
+    void build(const std::vector<T>& s, std::size_t node, std::size_t lo, std::size_t hi);
+
+    std::vector<T> tree;
+    unsigned int logBuckets;
+};
+
+template <typename T>
+SplitterTree<T>::SplitterTree(const std::vector<T>& sortedSplitters, unsigned int logBuckets)
+    : tree(std::size_t(1) << logBuckets),
+      logBuckets(logBuckets)
+{
+    build(sortedSplitters, 1, 0, sortedSplitters.size());
+}
+
+template <typename T>
+void SplitterTree<T>::build(const std::vector<T>& s, std::size_t node, std::size_t lo, std::size_t hi) {
+    if (node >= tree.size())
+        return;
+    std::size_t mid = (lo + hi) / 2;
+    tree[node] = s[mid];
+    build(s, 2 * node, lo, mid);
+    build(s, 2 * node + 1, mid + 1, hi);
+}
+
+template <typename T>
+std::size_t SplitterTree<T>::classify(T x) const noexcept {
+    std::size_t i = 1;
+    for (unsigned int l = 0; l < logBuckets; ++l)
+        i = 2 * i + (tree[i] < x);
+    return i - tree.size();
+}
+
+/*
+ * Tri par échantillonnage parallèle :
+ * 1. séparateurs tirés d'un échantillon trié (suréchantillonnage) ;
+ * 2. chaque tâche classe sa tranche, note le paquet de chaque élément et
+ *    compte ses propres paquets (aucun partage, donc aucune contention) ;
+ * 3. une somme préfixe donne à chaque tâche ses positions d'écriture ;
+ * 4. chaque tâche disperse sa tranche dans le tampon ;
+ * 5. les paquets, indépendants, sont triés (pdqsort) et recopiés en parallèle.
+ */
+template <typename T>
+void psample_sort(T* v, std::size_t n) {
+    if (n < PSAMPLE_CUTOFF) {
+        pdqsort(v, v + n, std::less<T>());
+        return;
+    }
+
+    unsigned int logBuckets = 1;
+    while ((std::size_t(1) << logBuckets) < PSAMPLE_MAX_BUCKETS &&
+           (n >> logBuckets) > PSAMPLE_BUCKET_TARGET)
+        ++logBuckets;
+    const std::size_t buckets = std::size_t(1) << logBuckets;
+
+    std::mt19937_64 rng(n);
+    std::vector<T> sample(buckets * PSAMPLE_OVERSAMPLING);
+    for (auto& x : sample)
+        x = v[rng() % n];
+    pdqsort(sample);
+    std::vector<T> splitters(buckets - 1);
+    for (std::size_t i = 0; i < splitters.size(); ++i)
+        splitters[i] = sample[(i + 1) * PSAMPLE_OVERSAMPLING];
+    const SplitterTree<T> tree(splitters, logBuckets);
+
+    const std::size_t parts = ThreadPool::global().size();
+    std::vector<std::uint8_t> oracle(n);
+    std::vector<std::vector<std::size_t>> hist(parts, std::vector<std::size_t>(buckets, 0));
+    auto sliceBegin = [&](std::size_t p) { return n * p / parts; };
+    {
+        TaskGroup group;
+        for (std::size_t p = 0; p < parts; ++p)
+            group.run([&, p] {
+                auto& h = hist[p];
+                for (std::size_t i = sliceBegin(p); i < sliceBegin(p + 1); ++i) {
+                    std::size_t b = tree.classify(v[i]);
+                    oracle[i] = b;
+                    h[b]++;
+                }
+            });
+        group.wait();
+    }
+
+    // Paquet par paquet, puis tâche par tâche : hist devient les positions.
+    std::vector<std::size_t> bucketStart(buckets + 1, 0);
+    std::size_t sum = 0;
+    for (std::size_t b = 0; b < buckets; ++b) {
+        bucketStart[b] = sum;
+        for (std::size_t p = 0; p < parts; ++p) {
+            std::size_t c = hist[p][b];
+            hist[p][b] = sum;
+            sum += c;
+        }
+    }
+    bucketStart[buckets] = n;
+
+    std::vector<T> buf(n);
+    {
+        TaskGroup group;
+        for (std::size_t p = 0; p < parts; ++p)
+            group.run([&, p] {
+                auto& pos = hist[p];
+                for (std::size_t i = sliceBegin(p); i < sliceBegin(p + 1); ++i)
+                    buf[pos[oracle[i]]++] = v[i];
+            });
+        group.wait();
+    }
+
+    {
+        TaskGroup group;
+        for (std::size_t b = 0; b < buckets; ++b)
+            group.run([&, b] {
+                auto first = buf.begin() + bucketStart[b];
+                auto last = buf.begin() + bucketStart[b + 1];
+                pdqsort(first, last, std::less<T>());
+                std::copy(first, last, v + bucketStart[b]);
+            });
+        group.wait();
+    }
+}
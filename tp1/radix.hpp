@@ -0,0 +1,208 @@
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include "keys.hpp"
+#include "pool.hpp"
+
+#pragma once
+
+// Largeur d'un chiffre : 11 bits donnent 6 passes sur 64 bits avec des
+// histogrammes de 2048 cases qui tiennent encore en cache L1/L2.
+const unsigned int RADIX_BITS = 11;
+
+/*
+ * Passes LSD sur les bits [0, bits) des clés : tous les histogrammes sont
+ * calculés en une seule lecture, et une passe dont tous les éléments
+ * partagent le même chiffre est sautée. Les passes alternent entre src et
+ * dst ; renvoie celui des deux qui contient le résultat.
+ */
+template <typename T>
+T* radix_passes(T* src, T* dst, std::size_t n, unsigned int bits) {
+    constexpr std::size_t BUCKETS = std::size_t(1) << RADIX_BITS;
+    constexpr std::size_t MASK = BUCKETS - 1;
+    const unsigned int passes = (bits + RADIX_BITS - 1) / RADIX_BITS;
+    if (n < 2)
+        return src;
+
+    std::vector<std::array<std::size_t, BUCKETS>> counts(passes);
+    for (auto& c : counts)
+        c.fill(0);
+    for (std::size_t i = 0; i < n; ++i) {
+        auto k = radix_key(src[i]);
+        for (unsigned int p = 0; p < passes; ++p)
+            counts[p][(k >> (p * RADIX_BITS)) & MASK]++;
+    }
+
+    for (unsigned int p = 0; p < passes; ++p) {
+        auto& c = counts[p];
+        const unsigned int shift = p * RADIX_BITS;
+        if (c[(radix_key(src[0]) >> shift) & MASK] == n)
+            continue;
+
+        std::size_t sum = 0;
+        for (auto& count : c) {
+            std::size_t tmp = count;
+            count = sum;
+            sum += tmp;
+        }
+        for (std::size_t i = 0; i < n; ++i)
+            dst[c[(radix_key(src[i]) >> shift) & MASK]++] = src[i];
+        std::swap(src, dst);
+    }
+    return src;
+}
+
+// Tri par base LSD sur toute la largeur de la clé de T (voir keys.hpp).
+template <typename T>
+void radix_sort(T* a, std::size_t n) {
+    std::vector<T> buf(n);
+    T* res = radix_passes(a, buf.data(), n, sizeof(RadixKey<T>) * 8);
+    if (res != a)
+        std::copy(res, res + n, a);
+}
+
+// Un vecteur échange simplement son tampon au lieu de le recopier.
+template <typename T>
+void radix_sort(std::vector<T>& v) {
+    std::vector<T> buf(v.size());
+    if (radix_passes(v.data(), buf.data(), v.size(), sizeof(RadixKey<T>) * 8) != v.data())
+        v.swap(buf);
+}
+
+// Sous ce seuil, le tri parallèle se contente du tri séquentiel.
+std::size_t PRADIX_CUTOFF = std::size_t(1) << 16;
+// Chiffre de poids fort traité en MSD : 256 paquets indépendants.
+const unsigned int PRADIX_MSD_BITS = 8;
+// Un paquet plus petit est trié par insertion.
+const std::size_t PRADIX_SMALL_BUCKET = 64;
+
+/*
+ * Tri par base parallèle. La première passe est MSD sur les 8 bits de poids
+ * fort qui varient réellement (le préfixe commun à toutes les clés, calculé
+ * à partir du min et du max, est ignoré) :
+ * 1. chaque tâche fait l'histogramme de sa tranche ;
+ * 2. une somme préfixe donne à chaque tâche ses positions d'écriture ;
+ * 3. la dispersion passe par des tampons de combinaison d'écriture logiciels,
+ *    une ligne de cache par paquet, vidés d'un bloc quand ils sont pleins :
+ *    256 flux d'écriture ne se disputent plus le cache et le TLB ;
+ * 4. les paquets, désormais indépendants, finissent en LSD chacun dans sa tâche.
+ */
+template <typename T>
+void parallel_radix_sort(T* v, std::size_t n) {
+    using U = RadixKey<T>;
+    constexpr std::size_t BUCKETS = std::size_t(1) << PRADIX_MSD_BITS;
+    constexpr std::size_t LINE = 64 / sizeof(T) ? 64 / sizeof(T) : 1;
+    if (n < PRADIX_CUTOFF) {
+        radix_sort(v, n);
+        return;
+    }
+
+    const std::size_t parts = ThreadPool::global().size();
+    auto sliceBegin = [&](std::size_t p) { return n * p / parts; };
+
+    std::vector<U> lows(parts), highs(parts);
+    {
+        TaskGroup group;
+        for (std::size_t p = 0; p < parts; ++p)
+            group.run([&, p] {
+                U lo = radix_key(v[sliceBegin(p)]), hi = lo;
+                for (std::size_t i = sliceBegin(p); i < sliceBegin(p + 1); ++i) {
+                    U k = radix_key(v[i]);
+                    lo = std::min(lo, k);
+                    hi = std::max(hi, k);
+                }
+                lows[p] = lo;
+                highs[p] = hi;
+            });
+        group.wait();
+    }
+    const U diff = *std::min_element(lows.begin(), lows.end()) ^
+                   *std::max_element(highs.begin(), highs.end());
+    if (diff == 0)
+        return;
+    unsigned int bits = 0;
+    while (bits < sizeof(U) * 8 && (diff >> bits) != 0)
+        ++bits;
+    const unsigned int shift = bits > PRADIX_MSD_BITS ? bits - PRADIX_MSD_BITS : 0;
+    auto digit = [shift](T x) { return static_cast<std::size_t>(radix_key(x) >> shift) & (BUCKETS - 1); };
+
+    std::vector<std::array<std::size_t, BUCKETS>> hist(parts);
+    {
+        TaskGroup group;
+        for (std::size_t p = 0; p < parts; ++p)
+            group.run([&, p] {
+                auto& h = hist[p];
+                h.fill(0);
+                for (std::size_t i = sliceBegin(p); i < sliceBegin(p + 1); ++i)
+                    h[digit(v[i])]++;
+            });
+        group.wait();
+    }
+
+    std::array<std::size_t, BUCKETS + 1> bucketStart;
+    std::size_t sum = 0;
+    for (std::size_t b = 0; b < BUCKETS; ++b) {
+        bucketStart[b] = sum;
+        for (std::size_t p = 0; p < parts; ++p) {
+            std::size_t c = hist[p][b];
+            hist[p][b] = sum;
+            sum += c;
+        }
+    }
+    bucketStart[BUCKETS] = n;
+
+    std::vector<T> buf(n);
+    {
+        TaskGroup group;
+        for (std::size_t p = 0; p < parts; ++p)
+            group.run([&, p] {
+                auto& pos = hist[p];
+                std::vector<T> wc(BUCKETS * LINE);
+                std::array<unsigned int, BUCKETS> fill;
+                fill.fill(0);
+                for (std::size_t i = sliceBegin(p); i < sliceBegin(p + 1); ++i) {
+                    std::size_t b = digit(v[i]);
+                    wc[b * LINE + fill[b]++] = v[i];
+                    if (fill[b] == LINE) {
+                        std::copy(&wc[b * LINE], &wc[b * LINE] + LINE, &buf[pos[b]]);
+                        pos[b] += LINE;
+                        fill[b] = 0;
+                    }
+                }
+                for (std::size_t b = 0; b < BUCKETS; ++b) {
+                    std::copy(&wc[b * LINE], &wc[b * LINE] + fill[b], buf.begin() + pos[b]);
+                    pos[b] += fill[b];
+                }
+            });
+        group.wait();
+    }
+
+    {
+        TaskGroup group;
+        for (std::size_t b = 0; b < BUCKETS; ++b) {
+            const std::size_t first = bucketStart[b], count = bucketStart[b + 1] - first;
+            if (count == 0)
+                continue;
+            group.run([&, first, count] {
+                T* a = buf.data() + first;
+                T* out = v + first;
+                if (count < PRADIX_SMALL_BUCKET) {
+                    // Insertion vers out sur les clés de base : stable, comme
+                    // les passes LSD, et même ordre qu'elles (-0 avant +0).
+                    for (std::size_t i = 0; i < count; ++i) {
+                        T x = a[i];
+                        std::size_t j = i;
+                        for (; j > 0 && radix_key(x) < radix_key(out[j - 1]); --j)
+                            out[j] = out[j - 1];
+                        out[j] = x;
+                    }
+                } else if (radix_passes(a, out, count, shift) == a) {
+                    std::copy(a, a + count, out);
+                }
+            });
+        }
+        group.wait();
+    }
+}
@@ -1,11 +1,17 @@
 #!/bin/bash
 
-echo "algo,taille,temps" > ./results.csv
+# Un seul processus par distribution : chaque fichier est chargé une fois,
+# chaque algorithme est répété sur des copies fraîches (voir sort bench, -r et -w).
+# La colonne distribution vient du nom des fichiers (voir gen.sh).
+# ./res.sh --memory ajoute l'empreinte mémoire de chaque algorithme (voir memory.hpp).
+algos="stdsort,qsort,pdq,dup,quick3,merge,mergeBU,mergeSeuil,mergeSeuilSimd,natural,pmerge,psample,radix,pradix,auto"
+# Le tri par insertion est quadratique : sur 500000 clés, ses répétitions
+# prendraient des heures. Il n'est mesuré qu'une fois, sur les petites tailles.
+slow="insertion"
+slow_sizes="1000 5000 10000"
 
-for algo in {"stdsort","qsort","insertion","merge","mergeSeuil"}; do
-        for ex in $(ls testset_*); do
-            size=$(echo $ex | cut -d_ -f2)
-            t=$(./tp.sh -e ${ex} -a $algo -t)
-            echo $algo,$size,$t
-        done
-done >> results.csv
+for d in random sorted reversed organ fewunique zipf sawtooth; do
+	./tp.sh bench -a $algos "$@" $(ls testset_${d}_*) | sed "1s/^/distribution,/;1!s/^/$d,/"
+	./tp.sh bench -a $slow "$@" -r 1 -w 0 $(for n in $slow_sizes; do ls testset_${d}_${n}_*; done) |
+		sed "1s/^/distribution,/;1!s/^/$d,/"
+done | awk 'NR == 1 || !/^distribution,/' > ./results.csv
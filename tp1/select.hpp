@@ -0,0 +1,80 @@
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#pragma once
+
+/*
+ * Sélection des k plus petites valeurs d'un flux en mémoire O(k).
+ * Les candidates s'accumulent dans un tampon de 2k places ; quand il est
+ * plein, nth_element (introselect) n'en garde que les k plus petites et la
+ * plus grande d'entre elles devient un seuil. Toute valeur qui n'est pas
+ * sous le seuil est ensuite rejetée par une seule comparaison : sur des
+ * données aléatoires c'est presque tout le flux, et le coût amorti reste
+ * O(1) par valeur (une compaction linéaire toutes les k candidates).
+ */
+template <typename T>
+class StreamSelect
+{
+public:
+    explicit StreamSelect(std::size_t k);
+
+    void push(const T* values, std::size_t n);
+    std::vector<T> smallest();
+    bool kth(T& value);
+
+private:
+    void compact();
+
+    std::size_t k;
+    std::vector<T> buf;
+    bool bounded = false;
+    T threshold = T();
+};
+
+template <typename T>
+StreamSelect<T>::StreamSelect(std::size_t k)
+    : k(k)
+{
+    buf.reserve(2 * k);
+}
+
+template <typename T>
+void StreamSelect<T>::push(const T* values, std::size_t n) {
+    if (k == 0)
+        return;
+    for (std::size_t i = 0; i < n; ++i) {
+        if (bounded && !(values[i] < threshold))
+            continue;
+        buf.push_back(values[i]);
+        if (buf.size() == 2 * k)
+            compact();
+    }
+}
+
+template <typename T>
+void StreamSelect<T>::compact() {
+    std::nth_element(buf.begin(), buf.begin() + (k - 1), buf.end());
+    buf.resize(k);
+    threshold = buf[k - 1];
+    bounded = true;
+}
+
+// Les min(k, n) plus petites valeurs vues, triées.
+template <typename T>
+std::vector<T> StreamSelect<T>::smallest() {
+    if (buf.size() > k)
+        compact();
+    std::sort(buf.begin(), buf.end());
+    return buf;
+}
+
+// La k-ième plus petite valeur (k à partir de 1), si le flux en contenait k.
+template <typename T>
+bool StreamSelect<T>::kth(T& value) {
+    if (k == 0 || buf.size() < k)
+        return false;
+    compact();
+    value = threshold;
+    return true;
+}
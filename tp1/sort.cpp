@@ -1,30 +1,58 @@
 #include <vector>
-#include <fstream>
 #include <functional>
 #include <chrono>
 #include <iostream>
 #include <algorithm>
 #include <iterator>
+#include <memory>
+#include <sstream>
+#include "alloc.hpp"
+#include "batch.hpp"
+#include "bench.hpp"
+#include "compact.hpp"
+#include "counters.hpp"
+#include "counting.hpp"
+#include "dup.hpp"
+#include "external.hpp"
+#include "io.hpp"
+#include "memory.hpp"
+#include "natural.hpp"
+#include "network.hpp"
+#include "pdq.hpp"
+#include "pmerge.hpp"
+#include "psample.hpp"
+#include "radix.hpp"
+#include "select.hpp"
+#include "strings.hpp"
+#include "tune.hpp"
 
 using Int = long long;
-using Algo = const std::function<void(std::vector<Int>&)>&;
+template <typename T>
+using Algo = void (*)(T*, std::size_t);
 
-void stdsort(std::vector<Int>& numbers) {
-    std::sort(numbers.begin(), numbers.end());
+// Sous ce seuil, mergeSeuil utilise le tri par insertion (voir --autotune).
+std::size_t MERGE_SEUIL = 1250;
+
+template <typename T>
+void stdsort(T* numbers, std::size_t n) {
+    std::sort(numbers, numbers + n);
 }
 
+template <typename T>
 int cmpfunc (const void * a, const void * b) {
     // cmpfunc doit renvoyer un int. On ne peut pas renvoyer directement
-    // res puisqu'il pourrait y avoir un overflow. Nous devons faire
-    // un traitement de plus qui ralentira le tri.
-    auto res = *(Int*)a - *(Int*)b;
-    if (res < 0) return -1;
-    else if (res > 0) return 1;
+    // la différence puisqu'il pourrait y avoir un overflow (ou, pour un type
+    // non signé, un repli modulo). Nous devons faire un traitement de plus
+    // qui ralentira le tri.
+    auto x = *(const T*)a, y = *(const T*)b;
+    if (x < y) return -1;
+    else if (y < x) return 1;
     else return 0;
 }
 
-void c_qsort(std::vector<Int>& numbers) {
-    qsort(&numbers[0], numbers.size(), sizeof(Int), cmpfunc);
+template <typename T>
+void c_qsort(T* numbers, std::size_t n) {
+    qsort(numbers, n, sizeof(T), cmpfunc<T>);
 }
 
 /*
@@ -46,8 +74,24 @@ void insertion_sort(RandomAccessIterator begin, RandomAccessIterator end) {
           typename std::iterator_traits<RandomAccessIterator>::value_type>());
 }
 
-void insertionSort(std::vector<Int>& numbers) {
-    insertion_sort(std::begin(numbers), std::end(numbers));
+template <typename T>
+void pdqSort(T* numbers, std::size_t n) {
+    pdqsort(numbers, numbers + n, std::less<T>());
+}
+
+template <typename T>
+void dupSort(T* numbers, std::size_t n) {
+    dup_sort(numbers, n);
+}
+
+template <typename T>
+void quick3Sort(T* numbers, std::size_t n) {
+    quick3_sort(numbers, n);
+}
+
+template <typename T>
+void insertionSort(T* numbers, std::size_t n) {
+    insertion_sort(numbers, numbers + n);
 }
 
 /*
@@ -71,77 +115,546 @@ template<typename RandomAccessIterator>
   mergesort(first, last, std::less<typename std::iterator_traits<RandomAccessIterator>::value_type>());
 }
 
-void mergeSort(std::vector<Int>& numbers) {
-    mergesort(std::begin(numbers), std::end(numbers));
+template <typename T>
+void mergeSort(T* numbers, std::size_t n) {
+    mergesort(numbers, numbers + n);
+}
+
+/*
+ * Tri fusion ascendant : un seul tableau auxiliaire de n éléments est alloué,
+ * et chaque passe fusionne des blocs de largeur w de la source vers la
+ * destination avant d'inverser leurs rôles. Aucune allocation par fusion,
+ * contrairement à std::inplace_merge.
+ */
+template<typename RandomAccessIterator, typename Order>
+ void mergesort_bottom_up(RandomAccessIterator first, RandomAccessIterator last, Order order)
+{
+  using T = typename std::iterator_traits<RandomAccessIterator>::value_type;
+  using Diff = typename std::iterator_traits<RandomAccessIterator>::difference_type;
+  const Diff n = last - first;
+  if (n < 2)
+    return;
+
+  std::vector<T> aux(n);
+  T* src = &*first;
+  T* dst = aux.data();
+  for (Diff w = 1; w < n; w *= 2)
+  {
+    for (Diff lo = 0; lo < n; lo += 2 * w)
+    {
+      auto mid = std::min(lo + w, n);
+      auto hi = std::min(lo + 2 * w, n);
+      std::merge(src + lo, src + mid, src + mid, src + hi, dst + lo, order);
+    }
+    std::swap(src, dst);
+  }
+  if (src != &*first)
+    std::copy(src, src + n, first);
+}
+
+template <typename T>
+void mergeBottomUpSort(T* numbers, std::size_t n) {
+    mergesort_bottom_up(numbers, numbers + n, std::less<T>());
+}
+
+template <typename T>
+void mergeSeuilSimdSort(T* numbers, std::size_t n) {
+    network_mergesort(numbers, n);
+}
+
+template <typename T>
+void naturalSort(T* numbers, std::size_t n) {
+    natural_mergesort(numbers, n);
 }
 
-void mergeSeuilSort(std::vector<Int>& numbers) {
-    if (numbers.size() < 1250) {
-        insertion_sort(std::begin(numbers), std::end(numbers));
+template <typename T>
+void pmergeSort(T* numbers, std::size_t n) {
+    pmergesort(numbers, n);
+}
+
+template <typename T>
+void mergeSeuilSort(T* numbers, std::size_t n) {
+    if (n < MERGE_SEUIL) {
+        insertion_sort(numbers, numbers + n);
     }
     else {
-        mergesort(std::begin(numbers), std::end(numbers));
+        mergesort(numbers, numbers + n);
+    }
+}
+
+template <typename T>
+void psampleSort(T* numbers, std::size_t n) {
+    psample_sort(numbers, n);
+}
+
+template <typename T>
+void radixSort(T* numbers, std::size_t n) {
+    radix_sort(numbers, n);
+}
+
+template <typename T>
+void pradixSort(T* numbers, std::size_t n) {
+    parallel_radix_sort(numbers, n);
+}
+
+template <typename T>
+void autoSort(T* numbers, std::size_t n) {
+    auto_sort(numbers, n);
+}
+
+void stringStdSort(const char* arena, StringRef* strings, std::size_t n) {
+    std::sort(strings, strings + n, [arena](const StringRef& a, const StringRef& b) {
+        return string_less_from(arena, a, b, 0);
+    });
+}
+
+void mkqsSort(const char* arena, StringRef* strings, std::size_t n) {
+    multikey_quicksort(arena, strings, n);
+}
+
+void msdSort(const char* arena, StringRef* strings, std::size_t n) {
+    msd_radix_sort(arena, strings, n);
+}
+
+void lcpMergeSort(const char* arena, StringRef* strings, std::size_t n) {
+    lcp_mergesort(arena, strings, n);
+}
+
+// Seuils réglés par --autotune et relus au démarrage
+std::vector<Tunable<Int>> tunables() {
+    return {
+        {"mergeSeuil", &MERGE_SEUIL, 1, {250, 500, 750, 1000, 1250, 1500, 2000, 3000},
+         {200, 400, 800, 1200, 1600, 2500, 4000}, mergeSeuilSort<Int>},
+        {"networkSeuil", &NETWORK_SEUIL, 2, {16, 32, 64, 128, 256, 512, 1024},
+         {10000, 100000, 1000000}, mergeSeuilSimdSort<Int>},
+        {"pmergeCutoff", &PMERGE_CUTOFF, 2, {1024, 2048, 4096, 8192, 16384, 32768, 65536},
+         {100000, 1000000}, pmergeSort<Int>},
+        {"pmergeGrain", &PMERGE_MERGE_GRAIN, 1, {4096, 16384, 65536, 262144},
+         {1000000}, pmergeSort<Int>},
+        {"psampleCutoff", &PSAMPLE_CUTOFF, 1, {16384, 32768, 65536, 131072, 262144},
+         {100000, 1000000}, psampleSort<Int>},
+        {"psampleBucket", &PSAMPLE_BUCKET_TARGET, 1, {1024, 2048, 4096, 8192, 16384},
+         {1000000}, psampleSort<Int>},
+        {"pradixCutoff", &PRADIX_CUTOFF, 1, {16384, 32768, 65536, 131072, 262144},
+         {100000, 1000000}, pradixSort<Int>},
+    };
+}
+
+template <typename T>
+Algo<T> findAlgo(const std::string& name) {
+    if (name == "stdsort")
+        return stdsort<T>;
+    else if(name == "qsort")
+        return c_qsort<T>;
+    else if(name == "pdq")
+        return pdqSort<T>;
+    else if(name == "dup")
+        return dupSort<T>;
+    else if(name == "quick3")
+        return quick3Sort<T>;
+    else if(name == "insertion")
+        return insertionSort<T>;
+    else if(name == "merge")
+        return mergeSort<T>;
+    else if(name == "mergeBU")
+        return mergeBottomUpSort<T>;
+    else if(name == "mergeSeuil")
+        return mergeSeuilSort<T>;
+    else if(name == "mergeSeuilSimd") {
+        // Les réseaux SIMD ne traitent que des clés signées de 64 bits
+        if constexpr (std::is_same<T, long long>::value)
+            return mergeSeuilSimdSort<T>;
+        return nullptr;
     }
+    else if(name == "natural")
+        return naturalSort<T>;
+    else if(name == "pmerge")
+        return pmergeSort<T>;
+    else if(name == "psample")
+        return psampleSort<T>;
+    else if(name == "radix")
+        return radixSort<T>;
+    else if(name == "pradix")
+        return pradixSort<T>;
+    else if(name == "auto")
+        return autoSort<T>;
+    return nullptr;
+}
+
+// An algorithm findAlgo cannot resolve for this key type stops the run
+void unknownAlgo(const std::string& name) {
+    std::cerr << "algorithme inconnu ou indisponible pour ce type : " << name << std::endl;
+}
+
+using StringAlgo = void (*)(const char*, StringRef*, std::size_t);
+
+StringAlgo findStringAlgo(const std::string& name) {
+    if (name == "stdsort")
+        return stringStdSort;
+    else if (name == "mkqs")
+        return mkqsSort;
+    else if (name == "msd")
+        return msdSort;
+    else if (name == "lcpmerge")
+        return lcpMergeSort;
+    return nullptr;
 }
 
-void run(Algo algo, std::vector<Int>& numbers, bool print_res, bool print_time) {
+struct ProgArgs {
+    std::string algo;
+    std::string file_path;
+    bool convert{false};
+    std::vector<std::string> convert_files;
+    bool in_place{false};
+    bool print_res{false};
+    bool print_time{false};
+    bool binary_res{false};
+    bool zero_copy{false};
+    std::size_t budget_mb{EXTERNAL_DEFAULT_BUDGET_MB};
+    std::string config_path{TUNE_DEFAULT_CONFIG};
+    bool autotune{false};
+    bool counters{false};
+    bool memory{false};
+    bool bench{false};
+    std::vector<std::string> bench_files;
+    unsigned int repeats{BENCH_DEFAULT_REPEATS};
+    unsigned int warmup{BENCH_DEFAULT_WARMUP};
+    std::vector<unsigned int> bench_threads;
+    bool compact{false};
+    std::size_t topk{0};
+    std::size_t select{0};
+    bool huge_pages{false};
+    std::string batch_dir;
+    std::string out_dir;
+    std::string type{"int64"};
+};
+
+// Time work(), which returns how many values it processed
+template <typename Work>
+void run(Work work, const ProgArgs& args) {
     using namespace std::chrono;
+    PerfCounters perf(args.counters);
+    // Pool threads started from now on inherit the counters
+    if (perf.available())
+        ThreadPool::restart();
+    MemoryAccount memory(args.memory);
+    memory.start();
+    if (args.counters)
+        perf.start();
     auto start = steady_clock::now();
-    algo(numbers);
+    std::size_t n = work();
     auto end = steady_clock::now();
+    auto usage = memory.stop();
+    auto events = perf.stop();
 
-    if (print_time) {
+    // With --counters and --memory, the hardware counters then the memory
+    // footprint follow on the same CSV line
+    if (args.print_time || args.counters || args.memory) {
         duration<double> s = end-start;
-        std::cout << std::fixed << s.count() << std::endl;
+        const char* sep = "";
+        if (args.print_time) {
+            std::cout << std::fixed << s.count();
+            sep = ",";
+        }
+        if (args.counters) {
+            std::cout << sep << PerfCounters::csv(events, n);
+            sep = ",";
+        }
+        if (args.memory)
+            std::cout << sep << MemoryAccount::csv(usage);
+        std::cout << std::endl;
+    }
+}
+
+// Sort the keys as offsets from lo stored in the narrower type Narrow
+template <typename Narrow, typename T>
+bool runNarrow(T* numbers, std::size_t n, T lo, const ProgArgs& args) {
+    auto algo = findAlgo<Narrow>(args.algo);
+    if (!algo)
+        return false;
+    auto narrow = narrow_keys<Narrow>(numbers, n, lo);
+    run([&] { algo(narrow.data(), n); return n; }, args);
+    widen_keys(narrow, lo, numbers);
+    return true;
+}
+
+// Everything after argument parsing, on keys of type T (see --type)
+template <typename T>
+int sortKeys(ProgArgs& prog_args) {
+    // Convert text files to the binary format, next to them (a.txt -> a.bin)
+    if (prog_args.convert) {
+        for (auto& path : prog_args.convert_files) {
+            auto dot = path.find_last_of('.');
+            auto slash = path.find_last_of('/');
+            std::string stem = (dot != std::string::npos && (slash == std::string::npos || dot > slash))
+                ? path.substr(0, dot) : path;
+            try {
+                convert_to_binary<T>(path, stem + ".bin");
+            } catch (const std::exception& e) {
+                std::cerr << e.what() << std::endl;
+                return 1;
+            }
+        }
+        return 0;
+    }
+
+    // Create the thread pool before timing anything
+    ThreadPool::global();
+
+    // Input array and sort buffers on huge pages from now on (see alloc.hpp)
+    HUGE_PAGES = prog_args.huge_pages && !prog_args.bench;
+
+    // Measure thresholds for this machine, or read the saved ones
+    if (prog_args.autotune) {
+        autotune(tunables());
+        save_config(prog_args.config_path, tunables());
+        return 0;
+    }
+    load_config(prog_args.config_path, tunables());
+
+    // Benchmark every listed algorithm (-a a,b,c) on every file, in process
+    if (prog_args.bench) {
+        if (!prog_args.file_path.empty())
+            prog_args.bench_files.push_back(prog_args.file_path);
+        std::vector<std::pair<std::string, Algo<T>>> algos;
+        std::stringstream names(prog_args.algo);
+        std::string name;
+        while (std::getline(names, name, ',')) {
+            auto algo = findAlgo<T>(name);
+            if (!algo) {
+                unknownAlgo(name);
+                return 1;
+            }
+            algos.emplace_back(name, algo);
+        }
+        // --hugepages measures both allocators, with the TLB misses beside them
+        try {
+            bench<T>(prog_args.bench_files, algos, prog_args.repeats, prog_args.warmup,
+                     prog_args.counters || prog_args.huge_pages, prog_args.memory, prog_args.bench_threads,
+                     prog_args.huge_pages, load_numbers<T>, std::cout);
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    // --batch dir sorts every file of dir into -o dir: a reader parses the next
+    // files while one worker per pool thread sorts and a writer drains results
+    if (!prog_args.batch_dir.empty()) {
+        auto algo = findAlgo<T>(prog_args.algo);
+        if (!algo) {
+            unknownAlgo(prog_args.algo);
+            return 1;
+        }
+        try {
+            batch_sort<T>(prog_args.batch_dir, algo, prog_args.out_dir, prog_args.binary_res,
+                          prog_args.print_time, prog_args.budget_mb << 20,
+                          ThreadPool::global().size());
+        } catch (const std::exception& e) {
+            // The first failing stage stopped the others; report it once
+            std::cerr << "lots : " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    // The external sort streams the file itself instead of loading it
+    if (prog_args.algo == "external") {
+        if (prog_args.budget_mb < EXTERNAL_MIN_BUDGET_MB) {
+            std::cerr << "budget du tri externe (-m) : au moins "
+                      << EXTERNAL_MIN_BUDGET_MB << " Mio" << std::endl;
+            return 1;
+        }
+        using namespace std::chrono;
+        auto start = steady_clock::now();
+        external_sort<T>(prog_args.file_path, prog_args.budget_mb << 20,
+                         prog_args.print_res, prog_args.binary_res, prog_args.zero_copy);
+        auto end = steady_clock::now();
+        if (prog_args.print_time) {
+            duration<double> s = end-start;
+            std::cout << std::fixed << s.count() << std::endl;
+        }
+        return 0;
+    }
+
+    // --topk K prints the K smallest values, --select K the K-th smallest (from 1).
+    // Both stream the file through a selection buffer of O(K) values, so the
+    // time includes reading and parsing.
+    if (prog_args.topk || prog_args.select) {
+        StreamSelect<T> selection(prog_args.topk ? prog_args.topk : prog_args.select);
+        run([&] {
+            return stream_numbers<T>(prog_args.file_path, [&](const T* values, std::size_t n) {
+                selection.push(values, n);
+            });
+        }, prog_args);
+        if (!prog_args.print_res)
+            return 0;
+        T kth;
+        if (prog_args.topk)
+            write_numbers(selection.smallest(), prog_args.binary_res, prog_args.zero_copy);
+        else if (selection.kth(kth))
+            write_numbers(&kth, 1, prog_args.binary_res, prog_args.zero_copy);
+        return 0;
+    }
+
+    auto algo = findAlgo<T>(prog_args.algo);
+    if (!algo) {
+        unknownAlgo(prog_args.algo);
+        return 1;
+    }
+
+    // Binary files are sorted in their mapping, text files are parsed into a vector
+    auto load_start = std::chrono::steady_clock::now();
+    std::vector<T> numbers;
+    std::unique_ptr<MappedKeys<T>> mapped;
+    try {
+        if (is_binary_file(prog_args.file_path))
+            mapped.reset(new MappedKeys<T>(prog_args.file_path, prog_args.in_place));
+        else
+            numbers = load_numbers<T>(prog_args.file_path);
+    } catch (const std::exception& e) {
+        // Unreadable file, or a binary file written for another --type
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    T* keys = mapped ? mapped->data() : numbers.data();
+    std::size_t n = mapped ? mapped->size() : numbers.size();
+    auto load_end = std::chrono::steady_clock::now();
+
+    // Load time goes to stderr so the output of -t stays a single value
+    if (prog_args.print_time) {
+        std::chrono::duration<double> s = load_end - load_start;
+        std::cerr << std::fixed << "chargement " << s.count() << std::endl;
+    }
+
+    // Apply correct algorithm, on 16 or 32-bit offsets if --compact allows it
+    bool sorted = false;
+    if constexpr (std::is_integral<T>::value) {
+        T lo = 0;
+        unsigned int bits = prog_args.compact ? range_bits(keys, n, lo) : sizeof(T) * 8;
+        sorted = (bits <= 16 && sizeof(T) > 2 && runNarrow<std::uint16_t>(keys, n, lo, prog_args)) ||
+                 (bits <= 32 && sizeof(T) > 4 && runNarrow<std::uint32_t>(keys, n, lo, prog_args));
+    }
+    if (!sorted)
+        run([&] { algo(keys, n); return n; }, prog_args);
+
+    if (prog_args.print_res)
+        write_numbers(keys, n, prog_args.binary_res, prog_args.zero_copy);
+    return 0;
+}
+
+// --type string: lines sorted as handles into one arena of characters
+int sortStrings(const ProgArgs& prog_args) {
+    auto algo = findStringAlgo(prog_args.algo);
+    if (!algo) {
+        unknownAlgo(prog_args.algo);
+        return 1;
     }
+    HUGE_PAGES = prog_args.huge_pages;
 
-    if (print_res) {
-        std::cout << std::fixed;
-        for (auto n : numbers)
-            std::cout << n << std::endl;
+    auto load_start = std::chrono::steady_clock::now();
+    StringSet strings;
+    try {
+        strings = load_strings(prog_args.file_path);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    auto load_end = std::chrono::steady_clock::now();
+    if (prog_args.print_time) {
+        std::chrono::duration<double> s = load_end - load_start;
+        std::cerr << std::fixed << "chargement " << s.count() << std::endl;
     }
+
+    const std::size_t n = strings.refs.size();
+    run([&] { algo(strings.arena.data(), strings.refs.data(), n); return n; }, prog_args);
+
+    if (prog_args.print_res)
+        write_strings(strings, prog_args.zero_copy);
+    return 0;
 }
 
 int main(int argc, char *argv[]) {
-    struct {
-        std::string algo;
-        std::string file_path;
-        bool print_res{false};
-        bool print_time{false};
-    } prog_args;
+    ProgArgs prog_args;
 
     // Read program arguments
     for (int i=1; i<argc; i++) {
         std::string arg(argv[i]);
-        if (arg == "-a") {
+        if (i == 1 && arg == "bench") {
+            prog_args.bench = true;
+        } else if (i == 1 && arg == "convert") {
+            prog_args.convert = true;
+        } else if (arg == "-a") {
             prog_args.algo = argv[i+1]; i++;
         } else if (arg == "-e") {
             prog_args.file_path = argv[i+1]; i++;
         } else if (arg == "-p") {
             prog_args.print_res = true;
+        } else if (arg == "-b") {
+            prog_args.print_res = true;
+            prog_args.binary_res = true;
+        } else if (arg == "--vmsplice") {
+            prog_args.zero_copy = true;
         } else if (arg == "-t") {
             prog_args.print_time = true;
+        } else if (arg == "-c") {
+            prog_args.config_path = argv[i+1]; i++;
+        } else if (arg == "--inplace") {
+            prog_args.in_place = true;
+        } else if (arg == "--topk") {
+            prog_args.topk = std::stoul(argv[i+1]); i++;
+        } else if (arg == "--select") {
+            prog_args.select = std::stoul(argv[i+1]); i++;
+        } else if (arg == "--type") {
+            prog_args.type = argv[i+1]; i++;
+        } else if (arg == "--batch") {
+            prog_args.batch_dir = argv[i+1]; i++;
+        } else if (arg == "-o") {
+            prog_args.out_dir = argv[i+1]; i++;
+        } else if (arg == "--hugepages") {
+            prog_args.huge_pages = true;
+        } else if (arg == "--compact") {
+            prog_args.compact = true;
+        } else if (arg == "--counters") {
+            prog_args.counters = true;
+        } else if (arg == "--memory") {
+            prog_args.memory = true;
+        } else if (arg == "--autotune") {
+            prog_args.autotune = true;
+        } else if (arg == "-m") {
+            prog_args.budget_mb = std::stoul(argv[i+1]); i++;
+        } else if (arg == "-j") {
+            ThreadPool::setThreadCount(std::stoul(argv[i+1])); i++;
+        } else if (arg == "-r") {
+            prog_args.repeats = std::stoul(argv[i+1]); i++;
+        } else if (arg == "-w") {
+            prog_args.warmup = std::stoul(argv[i+1]); i++;
+        } else if (arg == "--threads") {
+            std::stringstream counts(argv[i+1]); i++;
+            std::string count;
+            while (std::getline(counts, count, ','))
+                prog_args.bench_threads.push_back(std::stoul(count));
+        } else if (prog_args.bench) {
+            prog_args.bench_files.push_back(arg);
+        } else if (prog_args.convert) {
+            prog_args.convert_files.push_back(arg);
         }
     }
 
-    // Read numbers into vector
-    std::vector<Int> numbers;
-    {
-        std::fstream ex_file(prog_args.file_path);
-        Int n;
-        while (ex_file >> n)
-            numbers.push_back(n);
-    }
-
-    // Apply correct algorithm
-    if (prog_args.algo == "stdsort")
-        run(stdsort, numbers, prog_args.print_res, prog_args.print_time);
-    else if(prog_args.algo == "qsort")
-        run(c_qsort, numbers, prog_args.print_res, prog_args.print_time);
-    else if(prog_args.algo == "insertion")
-        run(insertionSort, numbers, prog_args.print_res, prog_args.print_time);
-    else if(prog_args.algo == "merge")
-        run(mergeSort, numbers, prog_args.print_res, prog_args.print_time);
-    else if(prog_args.algo == "mergeSeuil")
-        run(mergeSeuilSort, numbers, prog_args.print_res, prog_args.print_time);
+    // Resolve --type once: each key type runs its own instantiations
+    if (prog_args.type == "int64")
+        return sortKeys<Int>(prog_args);
+    else if (prog_args.type == "int32")
+        return sortKeys<std::int32_t>(prog_args);
+    else if (prog_args.type == "uint64")
+        return sortKeys<std::uint64_t>(prog_args);
+    else if (prog_args.type == "double")
+        return sortKeys<double>(prog_args);
+    else if (prog_args.type == "pairs")
+        return sortKeys<KeyPair>(prog_args);
+    else if (prog_args.type == "string")
+        return sortStrings(prog_args);
+    std::cerr << "type inconnu : " << prog_args.type << std::endl;
+    return 1;
 }
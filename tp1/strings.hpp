@@ -0,0 +1,328 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+#include <unistd.h>
+#include "io.hpp"
+
+#pragma once
+
+/*
+ * Tri de chaînes (--type string). Tous les caractères du fichier sont
+ * recopiés bout à bout dans une arène ; une chaîne n'est qu'un décalage et
+ * une longueur dans cette arène. Les tris déplacent ces poignées de 16
+ * octets, jamais les caractères, et il n'y a ni std::string ni allocation
+ * par chaîne. Ordre : octet par octet (non signé), comme LC_ALL=C sort.
+ * Les lignes ne contiennent pas d'octet nul : 0 marque la fin d'une chaîne.
+ */
+
+struct StringRef {
+    std::uint64_t offset;
+    std::uint32_t length;
+};
+
+struct StringSet {
+    std::vector<char> arena;
+    std::vector<StringRef> refs;
+};
+
+// Sous cette taille, le groupe est fini par insertion.
+const std::size_t STRING_INSERTION_SORT = 16;
+// Sous cette taille, le tri par base MSD passe à l'insertion.
+const std::size_t MSD_SMALL = 64;
+
+/*
+ * Charge un fichier texte, une chaîne par ligne ('\r' final retiré). Une
+ * seule copie du fichier forme l'arène, puis un balayage par memchr
+ * découpe les lignes.
+ */
+StringSet load_strings(const std::string& path) {
+    StringSet set;
+    MappedFile file(path);
+    if (!file.data())
+        return set;
+    set.arena.assign(file.data(), file.data() + file.size());
+    const char* begin = set.arena.data();
+    const char* end = begin + set.arena.size();
+    set.refs.reserve(count_lines(begin, end) + 1);
+    for (const char* first = begin; first < end;) {
+        auto eol = static_cast<const char*>(memchr(first, '\n', end - first));
+        const char* last = eol ? eol : end;
+        std::size_t length = last - first;
+        if (length > 0 && last[-1] == '\r')
+            --length;
+        set.refs.push_back({static_cast<std::uint64_t>(first - begin), static_cast<std::uint32_t>(length)});
+        first = last + 1;
+    }
+    return set;
+}
+
+// Écrit les chaînes dans l'ordre de refs, une par ligne, sur la sortie standard.
+void write_strings(const StringSet& set, bool zeroCopy) {
+    OutputWriter out(STDOUT_FILENO, zeroCopy);
+    for (auto& s : set.refs) {
+        out.bytes(set.arena.data() + s.offset, s.length);
+        out.bytes("\n", 1);
+    }
+}
+
+// Caractère de rang d (non signé), 0 après la fin.
+unsigned char string_char(const char* arena, const StringRef& s, std::size_t d) {
+    return d < s.length ? static_cast<unsigned char>(arena[s.offset + d]) : 0;
+}
+
+// a < b en ne regardant qu'à partir du rang depth (préfixe commun connu).
+bool string_less_from(const char* arena, const StringRef& a, const StringRef& b, std::size_t depth) {
+    const std::size_t la = a.length - depth, lb = b.length - depth;
+    int c = memcmp(arena + a.offset + depth, arena + b.offset + depth, std::min(la, lb));
+    return c < 0 || (c == 0 && la < lb);
+}
+
+// Longueur du plus long préfixe commun de a et b, qui partagent déjà depth caractères.
+std::size_t string_lcp(const char* arena, const StringRef& a, const StringRef& b, std::size_t depth) {
+    const std::size_t last = std::min(a.length, b.length);
+    const char* pa = arena + a.offset;
+    const char* pb = arena + b.offset;
+    while (depth < last && pa[depth] == pb[depth])
+        ++depth;
+    return depth;
+}
+
+// Tri par insertion de chaînes qui partagent leurs depth premiers caractères.
+void string_insertion_sort(const char* arena, StringRef* a, std::size_t n, std::size_t depth) {
+    for (std::size_t i = 1; i < n; ++i) {
+        StringRef x = a[i];
+        std::size_t j = i;
+        for (; j > 0 && string_less_from(arena, x, a[j - 1], depth); --j)
+            a[j] = a[j - 1];
+        a[j] = x;
+    }
+}
+
+/*
+ * Tri rapide multiclé (Bentley et Sedgewick, 1997) : partition en trois
+ * selon le seul caractère de rang depth. Les parties « plus petit » et
+ * « plus grand » gardent ce rang ; la partie égale passe au caractère
+ * suivant, sans jamais recomparer le préfixe commun. Chaque caractère est
+ * lu O(log n) fois en moyenne au lieu d'une comparaison complète par paire.
+ */
+void multikey_quicksort(const char* arena, StringRef* a, std::size_t n, std::size_t depth) {
+    while (n > STRING_INSERTION_SORT) {
+        auto at = [&](std::size_t i) { return string_char(arena, a[i], depth); };
+        // Médiane de trois caractères comme pivot, rangée en tête.
+        std::size_t m = n / 2, l = n - 1;
+        if (at(m) < at(0))
+            std::swap(a[m], a[0]);
+        if (at(l) < at(m)) {
+            std::swap(a[l], a[m]);
+            if (at(m) < at(0))
+                std::swap(a[m], a[0]);
+        }
+        std::swap(a[0], a[m]);
+        const unsigned char v = at(0);
+
+        // [0, lt) plus petits, [lt, i) égaux, [gt, n) plus grands.
+        std::size_t lt = 0, i = 1, gt = n;
+        while (i < gt) {
+            unsigned char c = at(i);
+            if (c < v)
+                std::swap(a[lt++], a[i++]);
+            else if (c > v)
+                std::swap(a[i], a[--gt]);
+            else
+                ++i;
+        }
+        multikey_quicksort(arena, a, lt, depth);
+        multikey_quicksort(arena, a + gt, n - gt, depth);
+        // Le groupe égal sur la fin de chaîne est entièrement trié.
+        if (v == 0)
+            return;
+        a += lt;
+        n = gt - lt;
+        ++depth;
+    }
+    string_insertion_sort(arena, a, n, depth);
+}
+
+void multikey_quicksort(const char* arena, StringRef* a, std::size_t n) {
+    multikey_quicksort(arena, a, n, 0);
+}
+
+/*
+ * Poignée du tri par base : les 8 caractères à partir d'un rang multiple de
+ * 8, en gros-boutiste (l'ordre des entiers est celui des chaînes), complétés
+ * par des zéros. Les chiffres se lisent dans ce cache, contigu au tableau
+ * trié : l'arène n'est relue qu'une fois tous les 8 caractères.
+ */
+struct CachedString {
+    std::uint64_t prefix;
+    StringRef ref;
+};
+
+std::uint64_t string_prefix(const char* arena, const StringRef& s, std::size_t depth) {
+    if (depth >= s.length)
+        return 0;
+    const char* p = arena + s.offset + depth;
+    const std::size_t left = s.length - depth;
+    std::uint64_t prefix = 0;
+    if (left >= 8) {
+        memcpy(&prefix, p, 8);
+        return __builtin_bswap64(prefix);
+    }
+    for (std::size_t i = 0; i < left; ++i)
+        prefix |= std::uint64_t(static_cast<unsigned char>(p[i])) << (56 - 8 * i);
+    return prefix;
+}
+
+/*
+ * Insertion sur les poignées d'un groupe de même préfixe jusqu'au rang
+ * depth : le cache départage, puis l'arène au-delà des 8 caractères s'il
+ * est identique et ne contient pas la fin de la chaîne.
+ */
+void cached_insertion_sort(const char* arena, CachedString* a, std::size_t n, std::size_t depth) {
+    const std::size_t next = depth - depth % 8 + 8;
+    auto less = [&](const CachedString& x, const CachedString& y) {
+        if (x.prefix != y.prefix)
+            return x.prefix < y.prefix;
+        return (x.prefix & 0xff) != 0 && string_less_from(arena, x.ref, y.ref, next);
+    };
+    for (std::size_t i = 1; i < n; ++i) {
+        CachedString x = a[i];
+        std::size_t j = i;
+        for (; j > 0 && less(x, a[j - 1]); --j)
+            a[j] = a[j - 1];
+        a[j] = x;
+    }
+}
+
+/*
+ * Tri par base MSD, un caractère (256 paquets) par niveau, lu dans le
+ * préfixe en cache. Le paquet 0 rassemble les chaînes finies : il est trié.
+ * Quand tout le groupe tombe dans un même paquet, on passe au caractère
+ * suivant sans rien déplacer. Tous les 8 caractères, le cache du groupe
+ * est rechargé depuis l'arène.
+ */
+void msd_radix_sort(const char* arena, CachedString* a, CachedString* tmp,
+                    std::size_t n, std::size_t depth) {
+    while (n >= MSD_SMALL) {
+        const unsigned int shift = 56 - 8 * (depth % 8);
+        std::size_t counts[256] = {};
+        for (std::size_t i = 0; i < n; ++i)
+            counts[(a[i].prefix >> shift) & 0xff]++;
+        if (counts[0] == n)
+            return;
+
+        if (counts[(a[0].prefix >> shift) & 0xff] != n) {
+            std::size_t pos[256];
+            std::size_t sum = 0;
+            for (std::size_t b = 0; b < 256; ++b) {
+                pos[b] = sum;
+                sum += counts[b];
+            }
+            for (std::size_t i = 0; i < n; ++i)
+                tmp[pos[(a[i].prefix >> shift) & 0xff]++] = a[i];
+            std::copy(tmp, tmp + n, a);
+
+            std::size_t start = counts[0];
+            for (std::size_t b = 1; b < 256; ++b) {
+                CachedString* group = a + start;
+                start += counts[b];
+                if (counts[b] < 2)
+                    continue;
+                if ((depth + 1) % 8 == 0)
+                    for (std::size_t i = 0; i < counts[b]; ++i)
+                        group[i].prefix = string_prefix(arena, group[i].ref, depth + 1);
+                msd_radix_sort(arena, group, tmp, counts[b], depth + 1);
+            }
+            return;
+        }
+
+        ++depth;
+        if (depth % 8 == 0)
+            for (std::size_t i = 0; i < n; ++i)
+                a[i].prefix = string_prefix(arena, a[i].ref, depth);
+    }
+    cached_insertion_sort(arena, a, n, depth);
+}
+
+void msd_radix_sort(const char* arena, StringRef* a, std::size_t n) {
+    std::vector<CachedString> cached(n), tmp(n);
+    for (std::size_t i = 0; i < n; ++i)
+        cached[i] = {string_prefix(arena, a[i], 0), a[i]};
+    msd_radix_sort(arena, cached.data(), tmp.data(), n, 0);
+    for (std::size_t i = 0; i < n; ++i)
+        a[i] = cached[i].ref;
+}
+
+/*
+ * Fusion consciente des LCP (Ng et Kakehi, 2008). Chaque suite triée porte
+ * h[i], la longueur du préfixe commun de s[i] avec s[i-1]. En tête de
+ * chaque suite, on connaît le préfixe commun avec le dernier élément sorti :
+ * si l'un est plus long, sa chaîne est la plus petite sans rien lire ;
+ * sinon on compare à partir de ce rang, et le préfixe commun trouvé sert à
+ * la suite. Aucun caractère d'un préfixe commun n'est relu.
+ */
+void lcp_merge(const char* arena,
+               const StringRef* s1, const std::size_t* h1, std::size_t n1,
+               const StringRef* s2, const std::size_t* h2, std::size_t n2,
+               StringRef* out, std::size_t* hout) {
+    std::size_t i = 0, j = 0, k = 0, ha = 0, hb = 0;
+    while (i < n1 && j < n2) {
+        bool first;
+        if (ha != hb) {
+            first = ha > hb;
+        } else {
+            std::size_t h = string_lcp(arena, s1[i], s2[j], ha);
+            first = h == s1[i].length ||
+                    (h < s2[j].length && string_char(arena, s1[i], h) < string_char(arena, s2[j], h));
+            // La chaîne qui reste en tête partage h caractères avec celle qui sort.
+            (first ? hb : ha) = h;
+        }
+        if (first) {
+            out[k] = s1[i];
+            hout[k++] = ha;
+            ha = ++i < n1 ? h1[i] : 0;
+        } else {
+            out[k] = s2[j];
+            hout[k++] = hb;
+            hb = ++j < n2 ? h2[j] : 0;
+        }
+    }
+    if (i < n1) {
+        out[k] = s1[i];
+        hout[k] = ha;
+        std::copy(s1 + i + 1, s1 + n1, out + k + 1);
+        std::copy(h1 + i + 1, h1 + n1, hout + k + 1);
+    } else if (j < n2) {
+        out[k] = s2[j];
+        hout[k] = hb;
+        std::copy(s2 + j + 1, s2 + n2, out + k + 1);
+        std::copy(h2 + j + 1, h2 + n2, hout + k + 1);
+    }
+}
+
+// Tri fusion descendant qui remplit h, les LCP entre voisins du résultat.
+void lcp_mergesort(const char* arena, StringRef* a, std::size_t* h, std::size_t n,
+                   StringRef* tmp, std::size_t* htmp) {
+    if (n <= STRING_INSERTION_SORT) {
+        string_insertion_sort(arena, a, n, 0);
+        for (std::size_t i = 0; i < n; ++i)
+            h[i] = i ? string_lcp(arena, a[i - 1], a[i], 0) : 0;
+        return;
+    }
+    const std::size_t m = n / 2;
+    lcp_mergesort(arena, a, h, m, tmp, htmp);
+    lcp_mergesort(arena, a + m, h + m, n - m, tmp, htmp);
+    lcp_merge(arena, a, h, m, a + m, h + m, n - m, tmp, htmp);
+    std::copy(tmp, tmp + n, a);
+    std::copy(htmp, htmp + n, h);
+}
+
+void lcp_mergesort(const char* arena, StringRef* a, std::size_t n) {
+    std::vector<std::size_t> h(n), htmp(n);
+    std::vector<StringRef> tmp(n);
+    lcp_mergesort(arena, a, h.data(), n, tmp.data(), htmp.data());
+}
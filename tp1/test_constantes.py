@@ -5,27 +5,46 @@ import numpy as np
 from scipy.stats import linregress
 import sys
 
-df = pd.read_csv(sys.argv[1]).groupby(['algo','taille']).mean().reset_index()
+df = pd.read_csv(sys.argv[1])
+# Une seule distribution d'entrée à la fois (deuxième argument, random par défaut)
+if 'distribution' in df:
+    dist = sys.argv[2] if len(sys.argv) > 2 else 'random'
+    df = df[df['distribution'] == dist].drop(columns='distribution')
+df = df.groupby(['algo','taille']).mean().reset_index()
 
 A = [
     ['stdsort', lambda x: x*np.log(x), '$nlogn$'],
     ['qsort', lambda x: x*np.log(x), '$nlogn$'],
+    ['pdq', lambda x: x*np.log(x), '$nlogn$'],
+    ['dup', lambda x: x*np.log(x), '$nlogn$'],
+    ['quick3', lambda x: x*np.log(x), '$nlogn$'],
     ['insertion', lambda x: x**2, '$n^2$'],
     ['merge', lambda x: x*np.log(x), '$nlogn$'],
-    ['mergeSeuil', lambda x: x*np.log(x), '$nlogn$']
+    ['mergeBU', lambda x: x*np.log(x), '$nlogn$'],
+    ['mergeSeuil', lambda x: x*np.log(x), '$nlogn$'],
+    ['mergeSeuilSimd', lambda x: x*np.log(x), '$nlogn$'],
+    ['natural', lambda x: x*np.log(x), '$nlogn$'],
+    ['pmerge', lambda x: x*np.log(x), '$nlogn$'],
+    ['psample', lambda x: x*np.log(x), '$nlogn$'],
+    ['radix', lambda x: x, '$n$'],
+    ['pradix', lambda x: x, '$n$'],
+    ['auto', lambda x: x, '$n$']
 ]
+rows = (len(A) + 2) // 3
 
-plt.figure(figsize=(12,4))
+plt.figure(figsize=(12,2*rows))
 
 for pos, a in enumerate(A):
     algo, hyp_f, hyp_str = a
     data = df[df.algo == algo].copy()
+    if data.empty:
+        continue
     
     data['hyp'] = hyp_f(data.taille)
     fit = np.polyfit(data.hyp, data.temps, 1)
     fit_fn = np.poly1d(fit)
     
-    ax = plt.subplot(2, 3, pos+1)
+    ax = plt.subplot(rows, 3, pos+1)
     ax.scatter(x=data.hyp, y=data.temps)
     ax.plot(data.hyp, fit_fn(data.hyp))
     
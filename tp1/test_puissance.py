@@ -3,7 +3,12 @@ import pandas as pd
 import seaborn as sns
 import sys
 
-df = pd.read_csv(sys.argv[1]).groupby(['algo','taille']).mean().reset_index()
+df = pd.read_csv(sys.argv[1])
+# Une seule distribution d'entrée à la fois (deuxième argument, random par défaut)
+if 'distribution' in df:
+    dist = sys.argv[2] if len(sys.argv) > 2 else 'random'
+    df = df[df['distribution'] == dist].drop(columns='distribution')
+df = df.groupby(['algo','taille']).mean().reset_index()
 
 g = sns.FacetGrid(df, hue='algo', size=4, aspect=1)
 g = g.map(plt.plot, 'taille', 'temps')
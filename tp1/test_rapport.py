@@ -4,25 +4,44 @@ import seaborn as sns
 import numpy as np
 import sys
 
-df = pd.read_csv(sys.argv[1]).groupby(['algo','taille']).mean().reset_index()
+df = pd.read_csv(sys.argv[1])
+# Une seule distribution d'entrée à la fois (deuxième argument, random par défaut)
+if 'distribution' in df:
+    dist = sys.argv[2] if len(sys.argv) > 2 else 'random'
+    df = df[df['distribution'] == dist].drop(columns='distribution')
+df = df.groupby(['algo','taille']).mean().reset_index()
 
 A = [
     ['stdsort', lambda x: x*np.log(x), '$nlogn$'],
     ['qsort', lambda x: x*np.log(x), '$nlogn$'],
+    ['pdq', lambda x: x*np.log(x), '$nlogn$'],
+    ['dup', lambda x: x*np.log(x), '$nlogn$'],
+    ['quick3', lambda x: x*np.log(x), '$nlogn$'],
     ['insertion', lambda x: x**2, '$n^2$'],
     ['merge', lambda x: x*np.log(x), '$nlogn$'],
-    ['mergeSeuil', lambda x: x*np.log(x), '$nlogn$']
+    ['mergeBU', lambda x: x*np.log(x), '$nlogn$'],
+    ['mergeSeuil', lambda x: x*np.log(x), '$nlogn$'],
+    ['mergeSeuilSimd', lambda x: x*np.log(x), '$nlogn$'],
+    ['natural', lambda x: x*np.log(x), '$nlogn$'],
+    ['pmerge', lambda x: x*np.log(x), '$nlogn$'],
+    ['psample', lambda x: x*np.log(x), '$nlogn$'],
+    ['radix', lambda x: x, '$n$'],
+    ['pradix', lambda x: x, '$n$'],
+    ['auto', lambda x: x, '$n$']
 ]
+rows = (len(A) + 2) // 3
 
-plt.figure(figsize=(12,4))
+plt.figure(figsize=(12,2*rows))
 
 for pos, a in enumerate(A):
     algo, hyp_f, hyp_str = a
     data = df[df.algo == algo].copy()
+    if data.empty:
+        continue
     
     data['rapport'] = data.temps / hyp_f(data.taille)
     
-    ax = plt.subplot(2, 3, pos+1)
+    ax = plt.subplot(rows, 3, pos+1)
     ax.scatter(x=data.taille, y=data.rapport)
     ax.plot(data.taille, data.rapport)
     
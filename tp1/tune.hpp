@@ -0,0 +1,125 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#pragma once
+
+// Fichier de configuration lu au démarrage et écrit par --autotune.
+const char* TUNE_DEFAULT_CONFIG = "sort.conf";
+// Nombre de mesures par candidat et par taille ; on garde la meilleure.
+const unsigned int TUNE_REPEATS = 3;
+
+/*
+ * Seuil réglable : sa variable, la plus petite valeur sûre (en dessous, la
+ * récursion ne s'arrête plus ou une division par zéro guette), les valeurs
+ * à essayer, les tailles de données synthétiques sur lesquelles les
+ * comparer et l'algorithme qui l'utilise.
+ */
+template <typename T>
+struct Tunable {
+    std::string name;
+    std::size_t* value;
+    std::size_t minimum;
+    std::vector<std::size_t> candidates;
+    std::vector<std::size_t> sizes;
+    void (*algo)(T*, std::size_t);
+};
+
+/*
+ * Lit les lignes « nom=valeur » et met à jour les seuils connus. Un fichier
+ * absent laisse les valeurs par défaut ; une valeur qui n'est pas un entier
+ * ou qui est sous le minimum du seuil est signalée et ignorée.
+ */
+template <typename T>
+void load_config(const std::string& path, const std::vector<Tunable<T>>& tunables) {
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line)) {
+        auto eq = line.find('=');
+        if (line.empty() || line[0] == '#' || eq == std::string::npos)
+            continue;
+        std::string key = line.substr(0, eq);
+        std::string text = line.substr(eq + 1);
+        for (auto& t : tunables) {
+            if (t.name != key)
+                continue;
+            std::size_t value = 0;
+            bool valid = !text.empty() && text.find_first_not_of("0123456789") == std::string::npos;
+            if (valid) {
+                try {
+                    value = std::stoull(text);
+                } catch (const std::out_of_range&) {
+                    valid = false;
+                }
+            }
+            if (valid && value >= t.minimum)
+                *t.value = value;
+            else
+                std::cerr << path << " : " << key << "=" << text << " ignoré (entier >= "
+                          << t.minimum << " attendu)" << std::endl;
+        }
+    }
+}
+
+template <typename T>
+void save_config(const std::string& path, const std::vector<Tunable<T>>& tunables) {
+    std::ofstream file(path);
+    file << "# Seuils mesurés par sort --autotune" << std::endl;
+    for (auto& t : tunables)
+        file << t.name << "=" << *t.value << std::endl;
+}
+
+/*
+ * Pour chaque seuil, chronomètre chaque candidat sur des permutations
+ * aléatoires de plusieurs tailles et garde celui dont le temps par élément,
+ * sommé sur les tailles, est le plus faible.
+ */
+template <typename T>
+void autotune(const std::vector<Tunable<T>>& tunables) {
+    using namespace std::chrono;
+    std::mt19937_64 rng(4705);
+
+    for (auto& t : tunables) {
+        std::vector<std::vector<T>> inputs;
+        for (auto n : t.sizes) {
+            std::vector<T> v(n);
+            for (std::size_t i = 0; i < n; ++i)
+                v[i] = static_cast<T>(i + 1);
+            std::shuffle(v.begin(), v.end(), rng);
+            inputs.push_back(std::move(v));
+        }
+
+        std::size_t best = *t.value;
+        double bestScore = -1;
+        for (auto c : t.candidates) {
+            *t.value = c;
+            double score = 0;
+            for (auto& input : inputs) {
+                double fastest = -1;
+                for (unsigned int r = 0; r < TUNE_REPEATS; ++r) {
+                    auto copy = input;
+                    auto start = steady_clock::now();
+                    t.algo(copy.data(), copy.size());
+                    auto end = steady_clock::now();
+                    double s = duration<double>(end - start).count();
+                    if (fastest < 0 || s < fastest)
+                        fastest = s;
+                }
+                score += fastest / input.size();
+            }
+            std::cerr << t.name << "=" << c << " : " << score << std::endl;
+            if (bestScore < 0 || score < bestScore) {
+                bestScore = score;
+                best = c;
+            }
+        }
+        *t.value = best;
+        std::cout << t.name << "=" << best << std::endl;
+    }
+}